@@ -1,7 +1,14 @@
 #ifndef _HPOWER_HPP
 #define _HPOWER_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
 #include "type_traits_custom.hpp"
+#include "HRegisterAccess.hpp"
+#include "HPowerTrace.hpp"
 
 #define __FORCE_INLINE __attribute__((always_inline)) inline
 
@@ -12,45 +19,247 @@ namespace controller::hardware{
 
 /*!
   @brief Implements hardware operations with Power(Clock) registers
+  @tparam <RegisterAccess> policy for registers reading and writing
+  @tparam <isTraced=true> whether modifications are recorded to 'PowerTrace' with POWER_TRACE.
+    Registers, which are not Power(Clock) registers, must not be traced: they would evict records of 'Profile'
 */
+template<typename RegisterAccess = DirectAccess, bool isTraced = true>
 class HPower{
 
+  static constexpr bool _isTraced = PowerTrace::enabled && isTraced;
+
 protected:
 
   HPower() = delete;
 
 /*!
-  @brief Set or Reset bits in the registers
+  @brief Set or Reset bits in the registers. If all owned bits of the register are set or reset,
+    then register is written without reading: not owned bits are taken from default value.
+    So register with owned bits must be written by this class only, and its not owned bits must stay at default value.
+    Entries with the same address are merged, so each register is accessed once, in order of addresses.
+    All registers are modified under single lock of 'RegisterAccess'.
+    With POWER_TRACE each modified register is read before and after modification and recorded to 'PowerTrace'
   @tparam <SetList> list of values to set 
   @tparam <ResetList> list of values to reset
   @tparam <AddressesList> list of registers addresses to operate
+  @tparam <OwnedList> list of bits, which are written only by this class. Other bits of register must stay at default value
+  @tparam <DefaultList> list of registers values after reset
 */
-  template<typename SetList, typename ResetList, typename AddressesList>
+  template<typename SetList, typename ResetList, typename AddressesList,
+           typename OwnedList, typename DefaultList>
   __FORCE_INLINE static void ModifyRegisters(){
-    using namespace utils;
+    ModifySequence<Modification<SetList, ResetList, AddressesList, OwnedList, DefaultList>>();
+  }
+
+/*!
+  @brief Parameters of single 'ModifyRegisters' step of 'ModifySequence'
+*/
+  template<typename SetList, typename ResetList, typename AddressesList,
+           typename OwnedList, typename DefaultList>
+  struct Modification{
+    Modification() = delete;
+  };
+
+/*!
+  @brief Performs 'ModifyRegisters' steps one after another under single lock of 'RegisterAccess',
+    e.g. reset assertion, clock enabling and reset release. Lock is not taken, if no register is modified
+  @tparam <Modifications> list of 'Modification' steps
+*/
+  template<typename... Modifications>
+  __FORCE_INLINE static void ModifySequence(){
+    if constexpr(((_PlanOf<Modifications>::type::size != 0) || ...)){
+      [[maybe_unused]] typename RegisterAccess::Lock lock;
+      (_ModifyRegisters<typename _PlanOf<Modifications>::type>(
+          std::make_index_sequence<_PlanOf<Modifications>::type::size>{}), ...);
+    }
+  }
+
+/*!
+  @brief Set registers to one of the states, selected at runtime. 
+    Masks of all states are placed in table, so operation takes constant time.
+    Bits, which are used in any state, but not in selected state, are reset.
+  @tparam <AddressesList> list of registers addresses to operate
+  @tparam <StatesLists> lists of values for each state
+  @param [in] stateIndex index of the state in 'StatesLists'. If it is out of range, registers are not modified
+*/
+  template<typename AddressesList, typename... StatesLists>
+  __FORCE_INLINE static void ApplyRegisters(std::size_t stateIndex){
+    if (stateIndex >= sizeof...(StatesLists))
+      return;
+    using tUsedList = utils::lists_termwise_or_t<StatesLists...>;
+    constexpr auto indices = std::make_index_sequence<utils::size_of_list_v<AddressesList>>{};
+    _ApplyRegisters<AddressesList, tUsedList, StatesLists...>(stateIndex, indices);
+  }
+
+/*!
+  @brief Set or Reset bits in the registers by masks, which are known at runtime only.
+    Registers without bits to modify are skipped. All registers are modified under single lock of 'RegisterAccess'
+  @tparam <AddressesList> list of registers addresses to operate
+  @param [in] set values to set, with layout of 'AddressesList'
+  @param [in] reset values to reset, with layout of 'AddressesList'
+*/
+  template<typename AddressesList, typename Value, std::size_t length>
+  __FORCE_INLINE static void ModifyRegisters(const std::array<Value, length>& set, 
+                                             const std::array<Value, length>& reset){
+    static_assert(length == utils::size_of_list_v<AddressesList>, "Masks do not match registers");
+    [[maybe_unused]] typename RegisterAccess::Lock lock;
+    _ModifyRegisters<AddressesList>(set, reset, std::make_index_sequence<length>{});
+  }
 
-    if constexpr (!is_empty_v<SetList> && !is_empty_v<ResetList> && !is_empty_v<AddressesList>){
+private:
 
-      constexpr auto valueSet = front_v<SetList>;
-      constexpr auto valueReset = front_v<ResetList>;
+  template<auto... values>
+  static constexpr auto _ToArray(utils::Valuelist<values...>){
+    return std::array{values...};
+  }
 
-      if constexpr(valueSet || valueReset){
-        constexpr auto address = front_v<AddressesList>;
-          
-        using pRegister_t = volatile std::remove_const_t<decltype(address)>* const;
-        auto& reg = *reinterpret_cast<pRegister_t>(address);
+  /*
+    Write plan: entries with the same address are merged, then entries without changes are dropped,
+    the rest are sorted by address. Owned bits are merged before dropping, so owned bits of entry
+    without changes are not overwritten by default value. Each register is accessed once, in order of addresses
+  */
+  template<typename SetList, typename ResetList, typename AddressesList,
+           typename OwnedList, typename DefaultList>
+  struct _WritePlan{
 
-        reg = (reg &(~valueReset)) | valueSet;
+    static constexpr auto _set = _ToArray(SetList{});
+    static constexpr auto _reset = _ToArray(ResetList{});
+    static constexpr auto _addresses = _ToArray(AddressesList{});
+    static constexpr auto _owned = _ToArray(OwnedList{});
+    static constexpr auto _defaults = _ToArray(DefaultList{});
+    static constexpr auto _length = std::min({_set.size(), _reset.size(), _addresses.size()});
+
+    using address_t = typename decltype(_addresses)::value_type;
+    using value_t = typename decltype(_set)::value_type;
+
+    struct Entry{
+      address_t address;
+      value_t set;
+      value_t reset;
+      value_t owned;
+      value_t value;
+    };
+
+    static constexpr auto _Plan(){
+      std::array<Entry, _length> plan{};
+      std::size_t size = 0;
+      for(std::size_t i = 0; i < _length; ++i){
+        std::size_t j = 0;
+        while(j < size && plan[j].address < _addresses[i])
+          ++j;
+        if (j < size && plan[j].address == _addresses[i]){
+          plan[j].set |= _set[i];
+          plan[j].reset |= _reset[i];
+          plan[j].owned |= _owned[i];
+          continue;
+        }
+        for(std::size_t k = size; k > j; --k)
+          plan[k] = plan[k - 1];
+        plan[j] = {_addresses[i], _set[i], _reset[i], _owned[i], _defaults[i]};
+        ++size;
       }
-        
-      using tRestSet = pop_front_t<SetList>;
-      using tRestReset = pop_front_t<ResetList>;
-      using tRestAddress = pop_front_t<AddressesList>;
-      
-      ModifyRegisters<tRestSet, tRestReset, tRestAddress>();
+      std::size_t kept = 0;
+      for(std::size_t i = 0; i < size; ++i)
+        if (plan[i].set | plan[i].reset)
+          plan[kept++] = plan[i];
+      return std::pair{plan, kept};
     }
+
+    static constexpr auto entries = _Plan().first;
+    static constexpr std::size_t size = _Plan().second;
+
   };
 
+  template<typename Step>
+  struct _PlanOf;
+
+  template<typename SetList, typename ResetList, typename AddressesList,
+           typename OwnedList, typename DefaultList>
+  struct _PlanOf<Modification<SetList, ResetList, AddressesList, OwnedList, DefaultList>>{
+    using type = _WritePlan<SetList, ResetList, AddressesList, OwnedList, DefaultList>;
+  };
+
+  template<typename Plan, std::size_t... indices>
+  __FORCE_INLINE static void _ModifyRegisters(std::index_sequence<indices...>){
+    constexpr auto& plan = Plan::entries;
+    (_ModifyRegister<plan[indices].address, plan[indices].set, plan[indices].reset, 
+                     plan[indices].owned, plan[indices].value>(), ...);
+  }
+
+  template<auto address, auto valueSet, auto valueReset, auto valueOwned, auto valueDefault>
+  __FORCE_INLINE static void _ModifyRegister(){
+    if constexpr(valueSet || valueReset){
+      [[maybe_unused]] std::remove_const_t<decltype(address)> valueOld{};
+      if constexpr(_isTraced)
+        valueOld = RegisterAccess:: template Read<address>();
+
+      if constexpr(valueOwned && !(valueOwned & ~(valueSet | valueReset))){
+        constexpr auto valueNotOwned = valueDefault & ~valueOwned;
+        RegisterAccess:: template Write<address>((valueNotOwned &(~valueReset)) | valueSet);
+      }
+      else
+        RegisterAccess:: template ModifyBits<address, valueReset, valueSet>();
+
+      if constexpr(_isTraced)
+        PowerTrace::Write(address, valueOld, RegisterAccess:: template Read<address>());
+    }
+  }
+
+  template<typename AddressesList, typename Value, std::size_t length, std::size_t... indices>
+  __FORCE_INLINE static void _ModifyRegisters(const std::array<Value, length>& set, 
+                                              const std::array<Value, length>& reset,
+                                              std::index_sequence<indices...>){
+    constexpr auto addresses = _ToArray(AddressesList{});
+    ([&]{
+      if (set[indices] | reset[indices]){
+        [[maybe_unused]] typename decltype(addresses)::value_type valueOld{};
+        if constexpr(_isTraced)
+          valueOld = RegisterAccess:: template Read<addresses[indices]>();
+
+        RegisterAccess:: template Modify<addresses[indices]>(reset[indices], set[indices]);
+
+        if constexpr(_isTraced)
+          PowerTrace::Write(addresses[indices], valueOld, RegisterAccess:: template Read<addresses[indices]>());
+      }
+    }(), ...);
+  }
+
+  template<typename Value>
+  struct _Masks{
+    Value set;
+    Value reset;
+  };
+
+  template<typename StateList, typename UsedList, std::size_t... indices>
+  static constexpr auto _StateMasks(std::index_sequence<indices...>){
+    constexpr auto set = _ToArray(StateList{});
+    constexpr auto used = _ToArray(UsedList{});
+    using value_t = typename decltype(used)::value_type;
+    return std::array{_Masks<value_t>{set[indices], used[indices] & ~set[indices]}...};
+  }
+
+  template<typename AddressesList, typename UsedList, typename... StatesLists, std::size_t... indices>
+  __FORCE_INLINE static void _ApplyRegisters(std::size_t stateIndex, std::index_sequence<indices...> sequence){
+    constexpr auto used = _ToArray(UsedList{});
+    constexpr auto addresses = _ToArray(AddressesList{});
+    static constexpr std::array table{_StateMasks<StatesLists, UsedList>(sequence)...};
+
+    const auto& masks = table[stateIndex];
+    [[maybe_unused]] typename RegisterAccess::Lock lock;
+    ([&]{
+      if constexpr(used[indices] != 0){
+        [[maybe_unused]] typename decltype(addresses)::value_type valueOld{};
+        if constexpr(_isTraced)
+          valueOld = RegisterAccess:: template Read<addresses[indices]>();
+
+        RegisterAccess:: template Modify<addresses[indices]>(masks[indices].reset, masks[indices].set);
+
+        if constexpr(_isTraced)
+          PowerTrace::Write(addresses[indices], valueOld, RegisterAccess:: template Read<addresses[indices]>());
+      }
+    }(), ...);
+  }
+
 };
 
 } // !namespace controller::hardware
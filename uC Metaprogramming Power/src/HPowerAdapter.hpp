@@ -0,0 +1,147 @@
+#ifndef _HPOWER_ADAPTER_HPP
+#define _HPOWER_ADAPTER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "IPower.hpp"
+#include "HPower.hpp"
+#include "type_traits_custom.hpp"
+
+#define __FORCE_INLINE __attribute__((always_inline)) inline
+
+/*!
+  @brief Hardware operations
+*/
+namespace controller::hardware{
+
+/*!
+  @brief Common part of Power adapters of controller families: implements hooks of IPower by HPower.
+    Adapter of family holds register tables only, which are accessed as 'Adapter<...>::Name':
+      AddressesList, DefaultList - enable registers and their reset values,
+      ResetAddressesList - reset registers in layout of 'fromValues', 0 for bus without reset register,
+      SleepAddressesList, SleepDefaultList - enable registers in Sleep mode, if family has them,
+      SleepKeptList - bits of Sleep mode registers, which 'SleepOnly' keeps at reset value: memories and flash interface.
+    E.g.: class BasicPower: public hardware::PowerAdapter<BasicPower, RegisterAccess, OwnedList>
+  @tparam <Adapter> adapter of family, with parameters 'RegisterAccess' and 'OwnedList'
+  @tparam <RegisterAccess> policy for registers reading and writing
+  @tparam <OwnedList> list of bits, which are written only by Power
+*/
+template<template<typename, typename> class Adapter, typename RegisterAccess, typename OwnedList>
+class PowerAdapter: public interfaces::IPower<Adapter<RegisterAccess, OwnedList>>,
+                    public HPower<RegisterAccess>{
+
+  PowerAdapter() = delete;
+
+  using _adapter = Adapter<RegisterAccess, OwnedList>;
+
+  template<typename List>
+  struct _all;
+
+  template<auto... values>
+  struct _all<utils::Valuelist<values...>>{
+    using type = utils::Valuelist<((void)values, uint32_t{0xFFFFFFFF})...>;
+  };
+
+  template<auto... addresses, auto... assertValues, auto... releaseValues>
+  static constexpr bool _HasReset(utils::Valuelist<addresses...>, utils::Valuelist<assertValues...>,
+                                  utils::Valuelist<releaseValues...>){
+    return ((addresses != 0 || (assertValues == 0 && releaseValues == 0)) && ...);
+  }
+
+protected:
+
+  template<typename List>
+  using _Owned = Adapter<RegisterAccess, List>;
+
+  using _Lock = typename RegisterAccess::Lock;
+
+  template<typename EnableList, typename DisableList>
+  __FORCE_INLINE static void _Set(){
+    using tOwnedList = utils::lists_termwise_or_t<typename _adapter::template fromValues<>::power, OwnedList>;
+    HPower<RegisterAccess>:: template
+        ModifyRegisters<EnableList, DisableList, typename _adapter::AddressesList,
+                        tOwnedList, typename _adapter::DefaultList>();
+  }
+
+  /*
+    Reset registers are written by Power only and are zero out of reset pulse,
+    so they are written without reading. Entries of bus without reset register are empty and skipped
+  */
+  template<typename AssertList, typename ReleaseList>
+  __FORCE_INLINE static void _SetReset(){
+    using tAddressesList = typename _adapter::ResetAddressesList;
+    static_assert(_HasReset(tAddressesList{}, AssertList{}, ReleaseList{}),
+                  "Peripherals of bus without reset register have no reset, e.g. AHB of STM32F1");
+    using tResetOwnedList = utils::lists_termwise_or_t<AssertList, ReleaseList>;
+    HPower<RegisterAccess>:: template
+        ModifyRegisters<AssertList, ReleaseList, tAddressesList,
+                        tResetOwnedList, typename _adapter::template fromValues<>::power>();
+  }
+
+  /*
+    Reset is asserted, clocks are enabled and reset is released under single lock
+  */
+  template<typename EnableList, typename ResetList>
+  __FORCE_INLINE static void _SetAndReset(){
+    using tAddressesList = typename _adapter::ResetAddressesList;
+    static_assert(_HasReset(tAddressesList{}, ResetList{}, ResetList{}),
+                  "Peripherals of bus without reset register have no reset, e.g. AHB of STM32F1");
+    using tOwnedList = utils::lists_termwise_or_t<typename _adapter::template fromValues<>::power, OwnedList>;
+    using tEmptyList = typename _adapter::template fromValues<>::power;
+    using tHPower = HPower<RegisterAccess>;
+    tHPower:: template ModifySequence<
+        typename tHPower:: template Modification<ResetList, tEmptyList, tAddressesList, ResetList, tEmptyList>,
+        typename tHPower:: template Modification<EnableList, tEmptyList, typename _adapter::AddressesList,
+                                                 tOwnedList, typename _adapter::DefaultList>,
+        typename tHPower:: template Modification<tEmptyList, ResetList, tAddressesList, ResetList, tEmptyList>>();
+  }
+
+  template<typename EnableList, typename DisableList>
+  __FORCE_INLINE static void _SetSleep(){
+    HPower<RegisterAccess>:: template
+        ModifyRegisters<EnableList, DisableList, typename _adapter::SleepAddressesList,
+                        typename _adapter::template fromValues<>::power, typename _adapter::SleepDefaultList>();
+  }
+
+  /*
+    All bits, except kept ones, are owned: registers are written without reading,
+    kept bits are taken from default value, unless they are enabled
+  */
+  template<typename EnableList>
+  __FORCE_INLINE static void _WriteSleep(){
+    using tAllList = typename _all<typename _adapter::SleepAddressesList>::type;
+    using tOwnedList = utils::lists_termwise_xor_t<tAllList, typename _adapter::SleepKeptList>;
+    using tDisableList = utils::lists_termwise_xor_t<utils::lists_termwise_or_t<EnableList, tOwnedList>, EnableList>;
+    HPower<RegisterAccess>:: template
+        ModifyRegisters<EnableList, tDisableList, typename _adapter::SleepAddressesList,
+                        tOwnedList, typename _adapter::SleepDefaultList>();
+  }
+
+  template<typename... StatesLists>
+  __FORCE_INLINE static void _Apply(std::size_t stateIndex){
+    HPower<RegisterAccess>:: template
+        ApplyRegisters<typename _adapter::AddressesList, StatesLists...>(stateIndex);
+  }
+
+  template<typename Value, std::size_t length>
+  __FORCE_INLINE static void _Modify(const std::array<Value, length>& set, const std::array<Value, length>& reset){
+    HPower<RegisterAccess>:: template ModifyRegisters<typename _adapter::AddressesList>(set, reset);
+  }
+
+#if defined(POWER_TRACE)
+  template<typename PowerList>
+  static PowerTrace::Usage _Profile(uint32_t now){
+    return PowerTrace:: template Profile<typename _adapter::AddressesList, PowerList>(now);
+  }
+#endif
+
+  friend class interfaces::IPower<_adapter>;
+
+};
+
+} // !namespace controller::hardware
+
+#undef __FORCE_INLINE
+
+#endif // !_HPOWER_ADAPTER_HPP
\ No newline at end of file
@@ -0,0 +1,199 @@
+#ifndef _HPOWER_TRACE_HPP
+#define _HPOWER_TRACE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "type_traits_custom.hpp"
+#if defined(POWER_TRACE) && !defined(__ARM_ARCH)
+#include <chrono>
+#endif
+
+#ifndef POWER_TRACE_CAPACITY
+#define POWER_TRACE_CAPACITY 64
+#endif
+
+/*!
+  @brief Hardware operations
+*/
+namespace controller::hardware{
+
+/*!
+  @brief Recorder of Power(Clock) registers transitions. Enabled by defining POWER_TRACE,
+    otherwise it is empty and all recording compiles away.
+    Last POWER_TRACE_CAPACITY (64 by default) transitions are kept in ring buffer.
+    Timestamp is DWT cycle counter on target (DWT must be enabled by application), us on host
+*/
+class PowerTrace{
+
+  PowerTrace() = delete;
+
+public:
+
+  /*!
+    @brief IPower operation, which has modified register
+  */
+  enum class Operation : uint8_t {
+    None, Enable, EnableExcept, Disable, DisableExcept, DisableUnshared, Keep,
+    Reset, EnableAndReset, EnableInSleep, DisableInSleep, SleepOnly, Transition, Apply, Transaction, AutoGate
+  };
+
+#if defined(POWER_TRACE)
+
+  static constexpr bool enabled = true;
+
+  /*!
+    @brief Single register transition
+  */
+  struct Record{
+    uint32_t timestamp;
+    uint32_t address;
+    uint32_t oldValue;
+    uint32_t newValue;
+    Operation operation;
+  };
+
+  /*!
+    @brief Time of peripheral with all 'power' bits set and number of its switches on and off
+  */
+  struct Usage{
+    uint32_t onTime;
+    std::size_t transitions;
+  };
+
+  static constexpr std::size_t capacity = POWER_TRACE_CAPACITY;
+
+  static inline std::array<Record, capacity> buffer{};
+  static inline std::size_t count = 0;
+  static inline Operation operation = Operation::None;
+
+  /*!
+    @brief Marks transitions, which are recorded while it exists, by operation.
+      Previous operation is restored on destruction
+  */
+  class Scope{
+
+    Operation _previous;
+
+  public:
+
+    explicit Scope(Operation current): _previous(operation){
+      operation = current;
+    }
+
+    ~Scope(){
+      operation = _previous;
+    }
+
+  };
+
+  static uint32_t Timestamp(){
+#if defined(__ARM_ARCH)
+    return *reinterpret_cast<volatile uint32_t*>(0xE0001004);
+#else
+    using namespace std::chrono;
+    return static_cast<uint32_t>(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+  }
+
+  /*!
+    @brief Records transition of register
+  */
+  static void Write(uint32_t address, uint32_t oldValue, uint32_t newValue){
+    buffer[count % capacity] = {Timestamp(), address, oldValue, newValue, operation};
+    ++count;
+  }
+
+  /*!
+    @brief Number of transitions, which are kept in buffer
+  */
+  static std::size_t Size(){
+    return count < capacity ? count : capacity;
+  }
+
+  /*!
+    @brief Kept transition, from oldest to newest
+    @param [in] index index of transition. Must be less than 'Size()'
+  */
+  static const Record& At(std::size_t index){
+    return buffer[(count - Size() + index) % capacity];
+  }
+
+  static void Clear(){
+    count = 0;
+  }
+
+  /*!
+    @brief Replays kept transitions and counts usage of peripheral.
+      Register, which is absent in trace, is taken as zero.
+      Peripheral, which is on at the end of trace, is counted as on until 'now'
+    @tparam <AddressesList> list of registers addresses
+    @tparam <PowerList> 'power' bits of peripheral, with layout of 'AddressesList'
+    @param [in] now timestamp of the end of replay
+  */
+  template<typename AddressesList, typename PowerList>
+  static Usage Profile(uint32_t now){
+    constexpr auto addresses = _ToArray(AddressesList{});
+    constexpr auto masks = _ToArray(PowerList{});
+    constexpr std::size_t length = addresses.size() < masks.size() ? addresses.size() : masks.size();
+
+    std::array<uint32_t, length> values{};
+    std::array<bool, length> isKnown{};
+    for(std::size_t i = 0; i < Size(); ++i)
+      for(std::size_t j = 0; j < length; ++j)
+        if (!isKnown[j] && At(i).address == addresses[j]){
+          values[j] = At(i).oldValue;
+          isKnown[j] = true;
+        }
+
+    auto isOn = [&]{
+      for(std::size_t j = 0; j < length; ++j)
+        if ((values[j] & masks[j]) != masks[j])
+          return false;
+      return true;
+    };
+
+    Usage usage{0, 0};
+    bool wasOn = isOn();
+    uint32_t since = Size() ? At(0).timestamp : now;
+    for(std::size_t i = 0; i < Size(); ++i){
+      for(std::size_t j = 0; j < length; ++j)
+        if (At(i).address == addresses[j])
+          values[j] = At(i).newValue;
+      if (bool on = isOn(); on != wasOn){
+        if (wasOn)
+          usage.onTime += At(i).timestamp - since;
+        since = At(i).timestamp;
+        wasOn = on;
+        ++usage.transitions;
+      }
+    }
+    if (wasOn)
+      usage.onTime += now - since;
+    return usage;
+  }
+
+private:
+
+  template<auto... values>
+  static constexpr auto _ToArray(utils::Valuelist<values...>){
+    return std::array<uint32_t, sizeof...(values)>{static_cast<uint32_t>(values)...};
+  }
+
+#else
+
+  static constexpr bool enabled = false;
+
+  struct Scope{
+    constexpr explicit Scope(Operation){}
+  };
+
+  static void Write(uint32_t, uint32_t, uint32_t){}
+
+#endif
+
+};
+
+} // !namespace controller::hardware
+
+#endif // !_HPOWER_TRACE_HPP
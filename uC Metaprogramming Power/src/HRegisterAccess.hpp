@@ -0,0 +1,431 @@
+#ifndef _HREGISTER_ACCESS_HPP
+#define _HREGISTER_ACCESS_HPP
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#define __FORCE_INLINE __attribute__((always_inline)) inline
+
+/*!
+  @brief Hardware operations
+*/
+namespace controller::hardware{
+
+/*!
+  @brief Register access policy for target. Registers are accessed
+    by absolute address through volatile pointer
+*/
+class DirectAccess{
+
+  DirectAccess() = delete;
+
+  template<auto address>
+  using pRegister_t = volatile std::remove_const_t<decltype(address)>* const;
+
+public:
+
+  /*!
+    @brief Guard of registers modification sequence. Does nothing
+  */
+  struct Lock{};
+
+  /*!
+    @brief Reads register
+    @tparam <address> register address
+  */
+  template<auto address>
+  __FORCE_INLINE static auto Read(){
+    return *reinterpret_cast<pRegister_t<address>>(address);
+  }
+
+  /*!
+    @brief Writes register
+    @tparam <address> register address
+    @param [in] value value to write
+  */
+  template<auto address>
+  __FORCE_INLINE static void Write(std::remove_const_t<decltype(address)> value){
+    *reinterpret_cast<pRegister_t<address>>(address) = value;
+  }
+
+  /*!
+    @brief Resets and sets bits of register by read-modify-write
+    @tparam <address> register address
+    @param [in] reset bits to reset
+    @param [in] set bits to set
+  */
+  template<auto address>
+  __FORCE_INLINE static void Modify(std::remove_const_t<decltype(address)> reset, 
+                                    std::remove_const_t<decltype(address)> set){
+    Write<address>((Read<address>() &(~reset)) | set);
+  }
+
+  /*!
+    @brief Resets and sets bits of register, which are known at compile time
+    @tparam <address> register address
+    @tparam <reset> bits to reset
+    @tparam <set> bits to set
+  */
+  template<auto address, auto reset, auto set>
+  __FORCE_INLINE static void ModifyBits(){
+    Modify<address>(reset, set);
+  }
+
+};
+
+/*!
+  @brief Peripheral bit-band region of Cortex-M3/M4. Each bit of region is mapped to word of alias:
+    write of 1 or 0 to word sets or resets the bit
+*/
+struct BitBand{
+
+  BitBand() = delete;
+
+  static constexpr std::uintmax_t 
+    region = 0x40000000,
+    size   = 0x00100000,
+    alias  = 0x42000000;
+
+  static constexpr bool IsRegion(std::uintmax_t address){
+    return address >= region && address < region + size;
+  }
+
+  static constexpr bool IsAlias(std::uintmax_t address){
+    return address >= alias && address < alias + size * 32;
+  }
+
+  /*!
+    @brief Address of register, whose bit is mapped to alias word
+  */
+  static constexpr std::uintmax_t Register(std::uintmax_t aliasAddress){
+    return region + (aliasAddress - alias) / 32 / 4 * 4;
+  }
+
+  /*!
+    @brief Mask of bit, which is mapped to alias word
+  */
+  static constexpr std::uintmax_t Bit(std::uintmax_t aliasAddress){
+    return std::uintmax_t{1} << ((aliasAddress - alias) / 4 % 32);
+  }
+
+  /*!
+    @brief Alias word of bit of register
+  */
+  static constexpr std::uintmax_t Alias(std::uintmax_t address, unsigned bit){
+    return alias + (address - region) * 32 + bit * 4;
+  }
+
+};
+
+/*!
+  @brief Register access policy for host. Each address is mapped to
+    variable in RAM, every read and write is counted and recorded to journal.
+    E.g.: using HostPower = BasicPower<hardware::SimulatedAccess>;
+*/
+class SimulatedAccess{
+
+  SimulatedAccess() = delete;
+
+public:
+
+  enum class Operation : uint8_t { Read, Write };
+
+  /*!
+    @brief Single register access
+  */
+  struct Record{
+    std::uintmax_t address;
+    std::uintmax_t value;
+    Operation operation;
+  };
+
+  /*!
+    @brief Number of records in journal. Accesses above are counted only
+  */
+  static constexpr std::size_t capacity = 256;
+
+  /*!
+    @brief Simulated register
+    @tparam <address> register address
+  */
+  template<auto address>
+  static inline std::remove_const_t<decltype(address)> registers{};
+
+  static inline std::array<Record, capacity> journal{};
+  static inline std::size_t reads = 0;
+  static inline std::size_t writes = 0;
+  static inline std::size_t locks = 0;
+
+  /*!
+    @brief Guard of registers modification sequence. Counts sequences only
+  */
+  struct Lock{
+    Lock(){ ++locks; }
+  };
+
+  /*!
+    @brief Total number of accesses since last 'Clear'
+  */
+  static std::size_t Accesses(){
+    return reads + writes;
+  }
+
+  /*!
+    @brief Clears counters and journal. Registers values remain unchanged
+  */
+  static void Clear(){
+    reads = writes = locks = 0;
+    journal = {};
+  }
+
+  template<auto address>
+  static auto Read(){
+    auto value = registers<address>;
+    _Record(address, value, Operation::Read);
+    ++reads;
+    return value;
+  }
+
+  template<auto address>
+  static void Write(std::remove_const_t<decltype(address)> value){
+    _Record(address, value, Operation::Write);
+    ++writes;
+    if constexpr(BitBand::IsAlias(address)){
+      constexpr decltype(address) target = BitBand::Register(address);
+      constexpr decltype(address) bit = BitBand::Bit(address);
+      registers<target> = value & 1 ? registers<target> | bit : registers<target> & ~bit;
+    }
+    else
+      registers<address> = value;
+  }
+
+  template<auto address>
+  static void Modify(std::remove_const_t<decltype(address)> reset, 
+                     std::remove_const_t<decltype(address)> set){
+    Write<address>((Read<address>() &(~reset)) | set);
+  }
+
+  template<auto address, auto reset, auto set>
+  static void ModifyBits(){
+    Modify<address>(reset, set);
+  }
+
+private:
+
+  static void _Record(std::uintmax_t address, std::uintmax_t value, Operation operation){
+    auto index = Accesses();
+    if (index < capacity)
+      journal[index] = {address, value, operation};
+  }
+
+};
+
+/*!
+  @brief Register access policy, which masks interrupts while registers are modified.
+    Interrupts are masked once for whole sequence of registers.
+    E.g.: using SafePower = BasicPower<hardware::MaskedAccess<>>;
+  @tparam <Access> policy for registers reading and writing
+*/
+template<typename Access = DirectAccess>
+class MaskedAccess: public Access{
+
+  MaskedAccess() = delete;
+
+public:
+
+  /*!
+    @brief Masks interrupts on creation, restores previous mask on destruction
+  */
+  class Lock{
+
+    typename Access::Lock _lock;
+
+#if defined(__ARM_ARCH)
+    uint32_t _primask;
+
+  public:
+
+    __FORCE_INLINE Lock(){
+      __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (_primask) :: "memory");
+    }
+
+    __FORCE_INLINE ~Lock(){
+      __asm volatile ("msr primask, %0" :: "r" (_primask) : "memory");
+    }
+#endif
+
+  };
+
+};
+
+/*!
+  @brief Register access policy, which modifies single bit of peripheral bit-band region
+    by one store to alias address instead of read-modify-write. Store to alias is atomic
+    and takes one bus access, while read-modify-write takes two.
+    E.g.: using Power = BasicPower<hardware::BitBandAccess<>>;
+  @tparam <Access> policy for registers reading and writing
+  @tparam <bitsLimit=1> maximal number of modified bits, which are written through alias
+*/
+template<typename Access = DirectAccess, unsigned bitsLimit = 1>
+class BitBandAccess: public Access{
+
+  BitBandAccess() = delete;
+
+  static constexpr unsigned _Count(uint32_t bits){
+    unsigned count = 0;
+    for(; bits; bits &= bits - 1)
+      ++count;
+    return count;
+  }
+
+  template<auto address, uint32_t bits>
+  __FORCE_INLINE static void _WriteBits(uint32_t value){
+    if constexpr(bits != 0){
+      constexpr uint32_t bit = bits & ~(bits - 1);
+      constexpr decltype(address) alias = BitBand::Alias(address, _Count(bit - 1));
+      Access:: template Write<alias>(value & bit ? 1 : 0);
+      _WriteBits<address, bits & (bits - 1)>(value);
+    }
+  }
+
+public:
+
+  template<auto address, auto reset, auto set>
+  __FORCE_INLINE static void ModifyBits(){
+    constexpr bool isBitBand = BitBand::IsRegion(address);
+    constexpr uint32_t bits = reset | set;
+
+    if constexpr(isBitBand && _Count(bits) <= bitsLimit)
+      _WriteBits<address, bits>(set);
+    else
+      Access:: template ModifyBits<address, reset, set>();
+  }
+
+};
+
+/*!
+  @brief Register access policy, which keeps copy of each register in RAM. Registers are never read,
+    except first access: modification is computed from copy and written by single store.
+    Copy is loaded from register on first access, so operations may be called from global constructors.
+    Register must be written by this policy only. Writes to bit-band alias are applied to copy of register,
+    so policy may be wrapped by BitBandAccess: BitBandAccess<ShadowAccess<>>. In ShadowAccess<BitBandAccess<>>
+    registers are always written by single store.
+    Without NDEBUG, copy is compared with register before each modification.
+    E.g.: using Power = BasicPower<hardware::ShadowAccess<>>;
+  @tparam <Access> policy for registers reading and writing
+*/
+template<typename Access = DirectAccess>
+class ShadowAccess: public Access{
+
+  ShadowAccess() = delete;
+
+  /*
+    Copies are zero initialized, which precedes any dynamic initialization, and are loaded on first access
+  */
+  template<auto address>
+  static inline std::remove_const_t<decltype(address)> _shadow{};
+
+  template<auto address>
+  static inline bool _isLoaded = false;
+
+  template<auto address>
+  __FORCE_INLINE static void _Check(){
+    assert(Access:: template Read<address>() == Shadow<address>() && "Register is modified bypassing shadow");
+  }
+
+public:
+
+  /*!
+    @brief Copy of register. Loaded from register on first access
+    @tparam <address> register address
+  */
+  template<auto address>
+  __FORCE_INLINE static std::remove_const_t<decltype(address)>& Shadow(){
+    if (!_isLoaded<address>){
+      _shadow<address> = Access:: template Read<address>();
+      _isLoaded<address> = true;
+    }
+    return _shadow<address>;
+  }
+
+  template<auto address>
+  __FORCE_INLINE static auto Read(){
+    return Shadow<address>();
+  }
+
+  template<auto address>
+  __FORCE_INLINE static void Write(std::remove_const_t<decltype(address)> value){
+    if constexpr(BitBand::IsAlias(address)){
+      constexpr decltype(address) target = BitBand::Register(address);
+      constexpr decltype(address) bit = BitBand::Bit(address);
+      _Check<target>();
+      auto& copy = Shadow<target>();
+      copy = value & 1 ? copy | bit : copy & ~bit;
+    }
+    else{
+      _Check<address>();
+      Shadow<address>() = value;
+    }
+    Access:: template Write<address>(value);
+  }
+
+  template<auto address>
+  __FORCE_INLINE static void Modify(std::remove_const_t<decltype(address)> reset, 
+                                    std::remove_const_t<decltype(address)> set){
+    Write<address>((Shadow<address>() &(~reset)) | set);
+  }
+
+  template<auto address, auto reset, auto set>
+  __FORCE_INLINE static void ModifyBits(){
+    Modify<address>(reset, set);
+  }
+
+};
+
+#if defined(__ARM_FEATURE_LDREX) && (__ARM_FEATURE_LDREX & 4)
+
+/*!
+  @brief Register access policy for target, which modifies registers by exclusive access.
+    Modification is repeated, if register was accessed by interrupt, so interrupts stay enabled
+*/
+class ExclusiveAccess: public DirectAccess{
+
+  ExclusiveAccess() = delete;
+
+public:
+
+  /*!
+    @brief Resets and sets bits of register by LDREX/STREX
+    @tparam <address> register address
+    @param [in] reset bits to reset
+    @param [in] set bits to set
+  */
+  template<auto address>
+  __FORCE_INLINE static void Modify(uint32_t reset, uint32_t set){
+    static_assert(sizeof(address) <= sizeof(uint32_t), "Only 32-bit registers are supported");
+    auto pRegister = reinterpret_cast<volatile uint32_t*>(address);
+    uint32_t value, failed;
+    do{
+      __asm volatile ("ldrex %0, [%1]" : "=r" (value) : "r" (pRegister) : "memory");
+      value = (value &(~reset)) | set;
+      __asm volatile ("strex %0, %2, [%1]" : "=&r" (failed) : "r" (pRegister), "r" (value) : "memory");
+    } while(failed);
+  }
+
+  template<auto address, auto reset, auto set>
+  __FORCE_INLINE static void ModifyBits(){
+    Modify<address>(reset, set);
+  }
+
+};
+
+#endif
+
+} // !namespace controller::hardware
+
+#undef __FORCE_INLINE
+
+#endif // !_HREGISTER_ACCESS_HPP
\ No newline at end of file
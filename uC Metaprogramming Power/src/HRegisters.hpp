@@ -0,0 +1,109 @@
+#ifndef _HREGISTERS_HPP
+#define _HREGISTERS_HPP
+
+#include <cstdint>
+#include "type_traits_custom.hpp"
+#include "HRegisterAccess.hpp"
+#include "HPower.hpp"
+
+#define __FORCE_INLINE __attribute__((always_inline)) inline
+
+/*!
+  @brief Hardware operations
+*/
+namespace controller::hardware{
+
+/*!
+  @brief Description of peripheral register
+  @tparam <registerAddress> register address
+  @tparam <resetValue=0> register value after reset
+*/
+template<uint32_t registerAddress, uint32_t resetValue = 0>
+struct Register{
+  Register() = delete;
+  static constexpr uint32_t address = registerAddress;
+  static constexpr uint32_t reset = resetValue;
+};
+
+/*!
+  @brief Description of register field
+  @tparam <Register> register of field, e.g. Register<0x40003800>
+  @tparam <position> position of least significant bit of field
+  @tparam <width=1> number of bits of field
+*/
+template<typename Register, unsigned position, unsigned width = 1>
+struct Field{
+
+  static_assert(width > 0 && position + width <= 32, "Field is out of 32-bit register");
+
+  Field() = delete;
+
+  static constexpr uint32_t address = Register::address;
+  static constexpr uint32_t reset = Register::reset;
+  static constexpr uint32_t mask = (width < 32 ? (1U << width) - 1U : ~0U) << position;
+
+  /*!
+    @brief Value of field for 'HRegisters'
+    @tparam <value> value of field, not shifted
+  */
+  template<uint32_t value>
+  struct Value{
+    static_assert(value <= (Field::mask >> position), "Value does not fit in field");
+    Value() = delete;
+    static constexpr uint32_t address = Register::address;
+    static constexpr uint32_t reset = Register::reset;
+    static constexpr uint32_t mask = Field::mask;
+    static constexpr uint32_t bits = value << position;
+  };
+
+};
+
+/*!
+  @brief Implements hardware operations with peripheral registers, described by 'Field'.
+    Values of fields are merged at compile time, so each register is accessed once,
+    under single lock of 'RegisterAccess'. Modifications are not recorded to 'PowerTrace'
+  @tparam <RegisterAccess> policy for registers reading and writing
+*/
+template<typename RegisterAccess = DirectAccess>
+class HRegisters: private HPower<RegisterAccess, false>{
+
+  HRegisters() = delete;
+
+public:
+
+/*!
+  @brief Writes registers of fields without reading. Fields, which are not listed, take reset value.
+    E.g.: HRegisters<>::Write<SPI<2>::CR1_MSTR::Value<1>, SPI<2>::CR1_BR::Value<3>>();
+  @tparam <Values> values of fields, e.g. Field<...>::Value<1>
+*/
+  template<typename... Values>
+  __FORCE_INLINE static void Write(){
+    HPower<RegisterAccess, false>:: template
+        ModifyRegisters<utils::Valuelist<Values::bits...>,
+                        utils::Valuelist<(Values::mask & ~Values::bits)...>,
+                        utils::Valuelist<Values::address...>,
+                        utils::Valuelist<Values::mask...>,
+                        utils::Valuelist<Values::reset...>>();
+  }
+
+/*!
+  @brief Modifies fields by read-modify-write of each register. Fields, which are not listed, are kept
+  @tparam <Values> values of fields, e.g. Field<...>::Value<1>
+*/
+  template<typename... Values>
+  __FORCE_INLINE static void Modify(){
+    HPower<RegisterAccess, false>:: template
+        ModifyRegisters<utils::Valuelist<Values::bits...>,
+                        utils::Valuelist<(Values::mask & ~Values::bits)...>,
+                        utils::Valuelist<Values::address...>,
+                        utils::Valuelist<(Values::mask & 0U)...>,
+                        utils::Valuelist<Values::reset...>>();
+  }
+
+};
+
+} // !namespace controller::hardware
+
+#undef __FORCE_INLINE
+
+#endif // !_HREGISTERS_HPP
@@ -1,7 +1,12 @@
 #ifndef _IPOWER_HPP
 #define _IPOWER_HPP
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
 #include "type_traits_custom.hpp"
+#include "HPowerTrace.hpp"
 
 #define __FORCE_INLINE __attribute__((always_inline)) inline
 
@@ -20,15 +25,172 @@ class IPower{
 
   IPower() = delete;
 
+  using _Trace = hardware::PowerTrace::Scope;
+  using _Operation = hardware::PowerTrace::Operation;
+
+  template<typename Peripheral, typename = void>
+  struct _dependencies{
+    using type = utils::Typelist<>;
+  };
+
+  template<typename Peripheral>
+  struct _dependencies<Peripheral, std::void_t<typename Peripheral::dependencies>>{
+    using type = typename Peripheral::dependencies;
+  };
+
+  /*
+    Dependencies and peripherals of list, e.g. of 'fromPeripherals'
+  */
+  template<typename Peripheral, typename = void>
+  struct _members{
+    using type = typename _dependencies<Peripheral>::type;
+  };
+
+  template<typename List>
+  struct _members<List, std::void_t<typename List::peripherals>>{
+    using type = typename List::peripherals;
+  };
+
+  /*
+    Transitive closure of 'dependencies' (or of 'Next'): each peripheral is visited once, so shared and cyclic
+    dependencies are taken once
+  */
+  template<typename Visited, typename Pending, template<typename, typename = void> class Next = _dependencies>
+  struct _closure{
+    using type = Visited;
+  };
+
+  template<typename... Visited, typename Peripheral, typename... Pending, template<typename, typename> class Next>
+  struct _closure<utils::Typelist<Visited...>, utils::Typelist<Peripheral, Pending...>, Next>{
+    using type = typename std::conditional_t<utils::contains_v<utils::Typelist<Visited...>, Peripheral>,
+        _closure<utils::Typelist<Visited...>, utils::Typelist<Pending...>, Next>,
+        _closure<utils::Typelist<Visited..., Peripheral>, 
+                 utils::concat_t<typename Next<Peripheral, void>::type, utils::Typelist<Pending...>>, Next>>::type;
+  };
+
+  template<typename Peripheral, typename = typename _closure<utils::Typelist<>, utils::Typelist<Peripheral>>::type>
+  struct _power;
+
+  template<typename Peripheral, typename... Closure>
+  struct _power<Peripheral, utils::Typelist<Closure...>>{
+    using type = utils::lists_termwise_or_t<typename Closure::power...>;
+  };
+
+  template<typename OwnedList>
+  struct _owned{
+    using type = typename adapter::template _Owned<typename _power<OwnedList>::type>;
+  };
+
+  template<typename Peripheral, typename = void>
+  struct _peripherals{
+    using type = utils::Typelist<Peripheral>;
+  };
+
+  template<typename List>
+  struct _peripherals<List, std::void_t<typename List::peripherals>>{
+    using type = typename List::peripherals;
+  };
+
+  template<typename Peripheral, typename... Peripherals>
+  static constexpr bool _isRequested = 
+      (utils::contains_v<typename _peripherals<Peripherals>::type, Peripheral> || ...);
+
+  template<typename ActiveList, typename... Peripherals>
+  struct _others;
+
+  template<typename... Active, typename... Peripherals>
+  struct _others<utils::Typelist<Active...>, Peripherals...>{
+    using tEmptyList = typename adapter::template fromValues<>::power;
+    using power = utils::lists_termwise_or_t<tEmptyList,
+        std::conditional_t<_isRequested<Active, Peripherals...>, tEmptyList, typename _power<Active>::type>...>;
+  };
+
+  template<typename Peripheral, typename = void>
+  struct _ownSleepPower{
+    using type = typename Peripheral::power;
+  };
+
+  template<typename Peripheral>
+  struct _ownSleepPower<Peripheral, std::void_t<typename Peripheral::sleep_power>>{
+    using type = typename Peripheral::sleep_power;
+  };
+
+  template<typename Peripheral, typename = typename _closure<utils::Typelist<>, utils::Typelist<Peripheral>>::type>
+  struct _sleepPower;
+
+  template<typename Peripheral, typename... Closure>
+  struct _sleepPower<Peripheral, utils::Typelist<Closure...>>{
+    using type = utils::lists_termwise_or_t<typename _ownSleepPower<Closure>::type...>;
+  };
+
+  template<typename Peripheral, typename = void>
+  struct _ownCurrent{
+    static constexpr uint32_t value = 0;
+  };
+
+  template<typename Peripheral>
+  struct _ownCurrent<Peripheral, std::void_t<decltype(Peripheral::current)>>{
+    static constexpr uint32_t value = Peripheral::current;
+  };
+
+  template<typename Closure>
+  struct _current;
+
+  template<typename... Closure>
+  struct _current<utils::Typelist<Closure...>>{
+    static constexpr uint32_t value = (uint32_t{0} + ... + _ownCurrent<Closure>::value);
+  };
+
+  template<typename Peripheral, typename = void>
+  struct _reset{
+    using type = typename adapter::template fromValues<>::power;
+  };
+
+  template<typename Peripheral>
+  struct _reset<Peripheral, std::void_t<typename Peripheral::reset>>{
+    using type = typename Peripheral::reset;
+  };
+
+  template<auto... values>
+  static constexpr bool _IsZero(utils::Valuelist<values...>){
+    return ((values == 0) && ...);
+  }
+
+  template<auto... values>
+  static constexpr auto _ToArray(utils::Valuelist<values...>){
+    return std::array{values...};
+  }
+
+  /*
+    Fails with names of both lists and common bits in layout of 'fromValues', e.g.:
+    _conflict<fromPeripherals<SPI<2>>, UART<1>, Valuelist<1, 0, 0>> - DMA1 bit in AHBENR
+  */
+  template<typename List, typename OtherList, typename CommonList>
+  struct _conflict{
+    static constexpr bool value = _IsZero(CommonList{});
+    static_assert(value, "POWER_STRICT: lists have common 'power' bits, which are neither enabled nor disabled. "
+                         "See 'List', 'OtherList' and 'CommonList' in instantiation of '_conflict'");
+  };
+
+  template<typename EnableList, typename DisableList>
+  __FORCE_INLINE static constexpr void _CheckKeep(){
+#if defined(POWER_STRICT)
+    using tCommonList = utils::lists_termwise_and_t<typename _power<EnableList>::type, typename _power<DisableList>::type>;
+    static_assert(_conflict<EnableList, DisableList, tCommonList>::value);
+#endif
+  }
+
 public:
 
   /*!
-    @brief Enables peripherals Power(Clock)
-    @tparam <Peripherals> list of peripherals with trait 'power'
+    @brief Enables peripherals Power(Clock). Power(Clock) of peripherals from trait 'dependencies'
+      is enabled too, transitively. The same applies to all operations with trait 'power'
+    @tparam <Peripherals> list of peripherals with trait 'power' and optional 'dependencies'
   */
   template<typename... Peripherals>
   __FORCE_INLINE static void Enable(){
-    using tEnableList = utils::lists_termwise_or_t<typename Peripherals::power...>;
+    [[maybe_unused]] _Trace trace{_Operation::Enable};
+    using tEnableList = utils::lists_termwise_or_t<typename _power<Peripherals>::type...>;
     using tDisableList = typename adapter::template fromValues<>::power;
    adapter:: template _Set<tEnableList, tDisableList>();
   }
@@ -36,13 +198,15 @@ public:
   /*!
     @brief Enables Power(Clock) except listed peripherals in 'ExceptList'. 
       If Enable = Exception = 1, then Enable = 0, otherwise depends on Enable.
+      Common bits are not touched: they are already enabled for 'ExceptList', e.g. DMA1 of UART, when SPI is woken up
     @tparam <EnableList> list to enable, with trait 'power'
     @tparam <ExceptList> list of exception, with trait 'power'
   */
   template<typename EnableList, typename ExceptList>
   __FORCE_INLINE static void EnableExcept(){
-    using tXORedList = utils::lists_termwise_xor_t<typename EnableList::power, typename ExceptList::power>;
-    using tEnableList = utils::lists_termwise_and_t<typename EnableList::power, tXORedList>;
+    [[maybe_unused]] _Trace trace{_Operation::EnableExcept};
+    using tXORedList = utils::lists_termwise_xor_t<typename _power<EnableList>::type, typename _power<ExceptList>::type>;
+    using tEnableList = utils::lists_termwise_and_t<typename _power<EnableList>::type, tXORedList>;
     using tDisableList = typename adapter::template fromValues<>::power;
     adapter:: template _Set<tEnableList, tDisableList>();
   }
@@ -53,7 +217,25 @@ public:
   */
   template<typename... Peripherals>
   __FORCE_INLINE static void Disable(){
-    using tDisableList = utils::lists_termwise_or_t<typename Peripherals::power...>;
+    [[maybe_unused]] _Trace trace{_Operation::Disable};
+    using tDisableList = utils::lists_termwise_or_t<typename _power<Peripherals>::type...>;
+    using tEnableList = typename adapter::template fromValues<>::power;
+    adapter:: template _Set<tEnableList, tDisableList>();
+  }
+
+  /*!
+    @brief Disables peripherals Power(Clock), which are not shared with other running peripherals.
+      E.g.: DMA1 of SPI stays enabled, while UART is in 'ActiveList'
+    @tparam <ActiveList> list of running peripherals, created by 'fromPeripherals'
+    @tparam <Peripherals> list of peripherals to disable, with trait 'power'
+  */
+  template<typename ActiveList, typename... Peripherals>
+  __FORCE_INLINE static void DisableUnshared(){
+    [[maybe_unused]] _Trace trace{_Operation::DisableUnshared};
+    using tOthersList = typename _others<typename _peripherals<ActiveList>::type, Peripherals...>::power;
+    using tRequestList = utils::lists_termwise_or_t<typename _power<Peripherals>::type...>;
+    using tXORedList = utils::lists_termwise_xor_t<tRequestList, tOthersList>;
+    using tDisableList = utils::lists_termwise_and_t<tRequestList, tXORedList>;
     using tEnableList = typename adapter::template fromValues<>::power;
     adapter:: template _Set<tEnableList, tDisableList>();
   }
@@ -61,41 +243,390 @@ public:
   /*!
     @brief Disables Power(Clock) except listed peripherals in 'ExceptList'. 
       If Disable = Exception = 1, then Disable = 0, otherwise depends on Disable.
+      Common bits stay enabled, e.g. DMA1 of SPI is kept for UART in 'ExceptList'
     @tparam <DisableList> list to disable, with trait 'power'
     @tparam <ExceptList> list of exception, with trait 'power'
   */
   template<typename DisableList, typename ExceptList>
   __FORCE_INLINE static void DisableExcept(){
-    using tXORedList = utils::lists_termwise_xor_t<typename DisableList::power, typename ExceptList::power>;
-    using tDisableList = utils::lists_termwise_and_t<typename DisableList::power, tXORedList>;
+    [[maybe_unused]] _Trace trace{_Operation::DisableExcept};
+    using tXORedList = utils::lists_termwise_xor_t<typename _power<DisableList>::type, typename _power<ExceptList>::type>;
+    using tDisableList = utils::lists_termwise_and_t<typename _power<DisableList>::type, tXORedList>;
     using tEnableList = typename adapter::template fromValues<>::power;
     adapter:: template _Set<tEnableList, tDisableList>();
   }
 
   /*!
     @brief Disable and Enables Power(Clock) depends on values. 
-      If Enable = Disable = 1, then Enable = Disable = 0, otherwise depends on values
+      If Enable = Disable = 1, then Enable = Disable = 0, otherwise depends on values.
+      With POWER_STRICT, common bits of 'EnableList' and 'DisableList' fail compilation
     @tparam <EnableList> list to enable, with trait 'power'
     @tparam <DisableList> list to disable, with trait 'power'
   */
   template<typename EnableList, typename DisableList>
   __FORCE_INLINE static void Keep(){
-    using tXORedList = utils::lists_termwise_xor_t<typename EnableList::power, typename DisableList::power>;
-    using tEnableList = utils::lists_termwise_and_t<typename EnableList::power, tXORedList>;
-    using tDisableList = utils::lists_termwise_and_t<typename DisableList::power, tXORedList>;
+    [[maybe_unused]] _Trace trace{_Operation::Keep};
+    _CheckKeep<EnableList, DisableList>();
+    using tXORedList = utils::lists_termwise_xor_t<typename _power<EnableList>::type, typename _power<DisableList>::type>;
+    using tEnableList = utils::lists_termwise_and_t<typename _power<EnableList>::type, tXORedList>;
+    using tDisableList = utils::lists_termwise_and_t<typename _power<DisableList>::type, tXORedList>;
     adapter:: template _Set<tEnableList, tDisableList>();
   }
 
   /*!
-    @brief Creates custom 'power' list from peripherals. Peripheral driver should implement 'power' trait.
+    @brief Resets peripherals: asserts and releases reset bits. 
+      Peripheral without trait 'reset' is skipped
+    @tparam <Peripherals> list of peripherals with trait 'reset'
+  */
+  template<typename... Peripherals>
+  __FORCE_INLINE static void Reset(){
+    [[maybe_unused]] _Trace trace{_Operation::Reset};
+    using tResetList = utils::lists_termwise_or_t<typename adapter::template fromValues<>::power,
+                                                  typename _reset<Peripherals>::type...>;
+    using tEmptyList = typename adapter::template fromValues<>::power;
+    adapter:: template _SetReset<tResetList, tEmptyList>();
+    adapter:: template _SetReset<tEmptyList, tResetList>();
+  }
+
+  /*!
+    @brief Enables peripherals Power(Clock) and resets them. 
+      Clocks of all peripherals are enabled, while reset is asserted, 
+      so each register is written once for assertion, enable and release, all under single lock.
+      Peripheral without trait 'reset' is enabled only
+    @tparam <Peripherals> list of peripherals with trait 'power' and 'reset'
+  */
+  template<typename... Peripherals>
+  __FORCE_INLINE static void EnableAndReset(){
+    [[maybe_unused]] _Trace trace{_Operation::EnableAndReset};
+    using tEnableList = utils::lists_termwise_or_t<typename _power<Peripherals>::type...>;
+    using tResetList = utils::lists_termwise_or_t<typename adapter::template fromValues<>::power,
+                                                  typename _reset<Peripherals>::type...>;
+    adapter:: template _SetAndReset<tEnableList, tResetList>();
+  }
+
+  /*!
+    @brief Enables peripherals Power(Clock) in sleep mode. 
+      Peripheral without trait 'sleep_power' uses trait 'power'
+    @tparam <Peripherals> list of peripherals with trait 'sleep_power' or 'power'
+  */
+  template<typename... Peripherals>
+  __FORCE_INLINE static void EnableInSleep(){
+    [[maybe_unused]] _Trace trace{_Operation::EnableInSleep};
+    using tEnableList = utils::lists_termwise_or_t<typename _sleepPower<Peripherals>::type...>;
+    using tDisableList = typename adapter::template fromValues<>::power;
+    adapter:: template _SetSleep<tEnableList, tDisableList>();
+  }
+
+  /*!
+    @brief Disables peripherals Power(Clock) in sleep mode. 
+      Peripheral without trait 'sleep_power' uses trait 'power'
+    @tparam <Peripherals> list of peripherals with trait 'sleep_power' or 'power'
+  */
+  template<typename... Peripherals>
+  __FORCE_INLINE static void DisableInSleep(){
+    [[maybe_unused]] _Trace trace{_Operation::DisableInSleep};
+    using tDisableList = utils::lists_termwise_or_t<typename _sleepPower<Peripherals>::type...>;
+    using tEnableList = typename adapter::template fromValues<>::power;
+    adapter:: template _SetSleep<tEnableList, tDisableList>();
+  }
+
+  /*!
+    @brief Enables in sleep mode Power(Clock) of listed peripherals only, all other bits are disabled,
+      except clocks of memories and flash interface, which keep reset value. Registers are written without reading
+    @tparam <Peripherals> list of peripherals with trait 'sleep_power' or 'power'
+  */
+  template<typename... Peripherals>
+  __FORCE_INLINE static void SleepOnly(){
+    [[maybe_unused]] _Trace trace{_Operation::SleepOnly};
+    using tEnableList = utils::lists_termwise_or_t<typename adapter::template fromValues<>::power,
+                                                   typename _sleepPower<Peripherals>::type...>;
+    adapter:: template _WriteSleep<tEnableList>();
+  }
+
+  /*!
+    @brief Estimation of supply current of peripherals, uA. Peripherals of lists and 'dependencies'
+      are counted too, each peripheral once. Peripheral without trait 'current' is not counted.
+      E.g.: static_assert(Power::current<listPowerInit> <= 3000, "Power budget is exceeded");
+    @tparam <Peripherals> list of peripherals with trait 'current'
+  */
+  template<typename... Peripherals>
+  static constexpr uint32_t current =
+      _current<typename _closure<utils::Typelist<>, utils::Typelist<Peripherals...>, _members>::type>::value;
+
+#if defined(POWER_TRACE)
+  /*!
+    @brief Replays 'PowerTrace' and counts time, while all 'power' bits of peripheral are set,
+      and number of its switches on and off. E.g.: auto usage = Power::Profile<spi>(now);
+    @tparam <Peripheral> peripheral or list of peripherals with trait 'power'
+    @param [in] now timestamp of the end of replay
+  */
+  template<typename Peripheral>
+  static hardware::PowerTrace::Usage Profile(uint32_t now){
+    return adapter:: template _Profile<typename _power<Peripheral>::type>(now);
+  }
+#endif
+
+  /*!
+    @brief Set of named power states. Transition between states modifies only bits,
+      which differ in states, and skips registers without changes.
+      E.g.: using Modes = Power::StateMachine<listPowerRun, listPowerSleep>;
+            Modes::Transition<listPowerRun, listPowerSleep>();
+    @tparam <States> list of states, with trait 'power'
+  */
+  template<typename... States>
+  class StateMachine{
+
+    StateMachine() = delete;
+
+  public:
+
+    /*!
+      @brief Switches Power(Clock) from one state to another.
+        Enables bits of 'To' absent in 'From', disables bits of 'From' absent in 'To'
+      @tparam <From> current state
+      @tparam <To> next state
+    */
+    template<typename From, typename To>
+    __FORCE_INLINE static void Transition(){
+      [[maybe_unused]] _Trace trace{_Operation::Transition};
+      static_assert(utils::contains_v<utils::Typelist<States...>, From>,
+                    "'From' is not a state of StateMachine");
+      static_assert(utils::contains_v<utils::Typelist<States...>, To>,
+                    "'To' is not a state of StateMachine");
+      using tDeltaList = utils::lists_termwise_xor_t<typename _power<From>::type, typename _power<To>::type>;
+      using tEnableList = utils::lists_termwise_and_t<typename _power<To>::type, tDeltaList>;
+      using tDisableList = utils::lists_termwise_and_t<typename _power<From>::type, tDeltaList>;
+      adapter:: template _Set<tEnableList, tDisableList>();
+    }
+
+    /*!
+      @brief Switches Power(Clock) to state, which is known at runtime only.
+        Masks of all states are precomputed to table, so switch takes constant time.
+        Bits of other states, which are absent in selected state, are disabled
+      @param [in] stateIndex index of state in 'States', e.g. received command. 
+        If it is out of range, Power(Clock) is not changed
+    */
+    __FORCE_INLINE static void Apply(std::size_t stateIndex){
+      [[maybe_unused]] _Trace trace{_Operation::Apply};
+      adapter:: template _Apply<typename _power<States>::type...>(stateIndex);
+    }
+
+    /*!
+      @brief Estimation of supply current in each state, uA. For power budget reports
+    */
+    static constexpr std::array<uint32_t, sizeof...(States)> currents{IPower::template current<States>...};
+
+  };
+
+  /*!
+    @brief Sequence of operations, which are merged at compile time and committed at once:
+      each register is modified once under single lock. Later operation overrides earlier one.
+      E.g.: using Init = Power::Transaction<>::Enable<spi>::Enable<uart>::Disable<adc>;
+            Init::Commit();
+    @tparam <SetList> accumulated list of bits to enable
+    @tparam <ResetList> accumulated list of bits to disable
+  */
+  template<typename SetList = utils::Valuelist<>, typename ResetList = utils::Valuelist<>>
+  class Transaction{
+
+    Transaction() = delete;
+
+    template<typename List, typename MaskList>
+    using _clear = utils::lists_termwise_xor_t<List, utils::lists_termwise_and_t<List, MaskList>>;
+
+    template<typename EnableList, typename DisableList>
+    using _then = Transaction<utils::lists_termwise_or_t<_clear<SetList, DisableList>, EnableList>,
+                              utils::lists_termwise_or_t<_clear<ResetList, EnableList>, DisableList>>;
+
+  public:
+
+    /*!
+      @brief Adds enabling of peripherals Power(Clock)
+      @tparam <Peripherals> list of peripherals with trait 'power'
+    */
+    template<typename... Peripherals>
+    using Enable = _then<utils::lists_termwise_or_t<typename _power<Peripherals>::type...>, 
+                         typename adapter::template fromValues<>::power>;
+
+    /*!
+      @brief Adds disabling of peripherals Power(Clock)
+      @tparam <Peripherals> list of peripherals with trait 'power'
+    */
+    template<typename... Peripherals>
+    using Disable = _then<typename adapter::template fromValues<>::power, 
+                          utils::lists_termwise_or_t<typename _power<Peripherals>::type...>>;
+
+    /*!
+      @brief Adds enabling and disabling, as 'IPower::Keep'
+      @tparam <EnableList> list to enable, with trait 'power'
+      @tparam <DisableList> list to disable, with trait 'power'
+    */
+    template<typename EnableList, typename DisableList>
+    using Keep = _then<_clear<typename _power<EnableList>::type, typename _power<DisableList>::type>,
+                       _clear<typename _power<DisableList>::type, typename _power<EnableList>::type>>;
+
+    /*!
+      @brief Writes all accumulated operations
+    */
+    __FORCE_INLINE static void Commit(){
+      [[maybe_unused]] _Trace trace{_Operation::Transaction};
+      using tEmptyList = typename adapter::template fromValues<>::power;
+      adapter:: template _Set<utils::lists_termwise_or_t<tEmptyList, SetList>,
+                              utils::lists_termwise_or_t<tEmptyList, ResetList>>();
+    }
+
+  };
+
+  /*!
+    @brief Runtime gating of peripherals: Power(Clock) is enabled on first 'Use' and disabled,
+      when peripheral is not used during 'idleTicks' calls of 'Tick'. 'Use' enables peripheral with its
+      dependencies, while 'Tick' disables own bits of peripheral and bits of dependencies, which are in the set,
+      e.g. DMA<1> of Power::AutoGate<10, spi, uart, DMA<1>>. Other dependencies, e.g. GPIO, stay enabled.
+      Bits, which are shared with other powered peripherals of the set, stay enabled. Peripherals of the set
+      should not be enabled or disabled by other operations. 'Use' and 'Tick' run under lock of 'RegisterAccess',
+      so with MaskedAccess they may be called from interrupts of each other.
+      E.g.: using Gate = Power::AutoGate<10, spi, uart>;
+            Gate::Use<spi>(); spi::Transmit(data, size);   // in application
+            Gate::Tick();                                 // in periodic timer
+    @tparam <idleTicks> number of ticks without 'Use', after which peripheral is disabled
+    @tparam <Peripherals> list of peripherals with trait 'power', 32 at most
+  */
+  template<uint32_t idleTicks, typename... Peripherals>
+  class AutoGate{
+
+    static_assert(sizeof...(Peripherals) > 0 && sizeof...(Peripherals) <= 32, "AutoGate takes 1..32 peripherals");
+    static_assert(idleTicks > 0, "Peripheral must be idle at least one tick");
+
+    AutoGate() = delete;
+
+    using tEmptyList = typename adapter::template fromValues<>::power;
+
+    template<typename Peripheral>
+    using _powerList = utils::lists_termwise_or_t<tEmptyList, typename _power<Peripheral>::type>;
+
+    template<typename Peripheral, typename = typename _closure<utils::Typelist<>, utils::Typelist<Peripheral>>::type>
+    struct _gatedPower;
+
+    template<typename Peripheral, typename... Closure>
+    struct _gatedPower<Peripheral, utils::Typelist<Closure...>>{
+      using type = utils::lists_termwise_or_t<tEmptyList,
+          std::conditional_t<utils::contains_v<utils::Typelist<Peripherals...>, Closure>,
+                             typename Closure::power, tEmptyList>...>;
+    };
+
+    static constexpr std::array _masks{_ToArray(_powerList<Peripherals>{})...};
+    static constexpr std::array _gatedMasks{_ToArray(typename _gatedPower<Peripherals>::type{})...};
+
+    template<typename Peripheral>
+    static constexpr uint32_t _Bit(){
+      static_assert(utils::contains_v<utils::Typelist<Peripherals...>, Peripheral>,
+                    "Peripheral is not in AutoGate");
+      constexpr bool isSame[] = {std::is_same_v<Peripheral, Peripherals>...};
+      uint32_t index = 0;
+      while(!isSame[index])
+        ++index;
+      return 1U << index;
+    }
+
+    static inline uint32_t _powered = 0;
+    static inline uint32_t _used = 0;
+    static inline std::array<uint32_t, sizeof...(Peripherals)> _idle{};
+
+  public:
+
+    /*!
+      @brief Marks peripheral as used and enables its Power(Clock), if it is disabled
+      @tparam <Peripheral> peripheral of the set
+    */
+    template<typename Peripheral>
+    __FORCE_INLINE static void Use(){
+      constexpr uint32_t bit = _Bit<Peripheral>();
+      [[maybe_unused]] typename adapter::_Lock lock;
+      _used |= bit;
+      if (!(_powered & bit)){
+        _powered |= bit;
+        [[maybe_unused]] _Trace trace{_Operation::AutoGate};
+        adapter:: template _Set<_powerList<Peripheral>, tEmptyList>();
+      }
+    }
+
+    /*!
+      @brief Counts idle ticks of powered peripherals and disables Power(Clock) of expired ones
+    */
+    static void Tick(){
+      [[maybe_unused]] typename adapter::_Lock lock;
+      uint32_t expired = 0;
+      for(std::size_t i = 0; i < _idle.size(); ++i){
+        uint32_t bit = 1U << i;
+        if (!(_powered & bit))
+          continue;
+        if (_used & bit)
+          _idle[i] = 0;
+        else if (++_idle[i] >= idleTicks)
+          expired |= bit;
+      }
+      _used = 0;
+      if (!expired)
+        return;
+
+      _powered &= ~expired;
+      using tMasks = typename decltype(_masks)::value_type;
+      tMasks set{}, reset{}, kept{};
+      for(std::size_t i = 0; i < _idle.size(); ++i){
+        uint32_t bit = 1U << i;
+        for(std::size_t j = 0; j < reset.size(); ++j){
+          if (expired & bit)
+            reset[j] |= _gatedMasks[i][j];
+          if (_powered & bit)
+            kept[j] |= _masks[i][j];
+        }
+        if (expired & bit)
+          _idle[i] = 0;
+      }
+      for(std::size_t j = 0; j < reset.size(); ++j)
+        reset[j] &= ~kept[j];
+
+      [[maybe_unused]] _Trace trace{_Operation::AutoGate};
+      adapter::_Modify(set, reset);
+    }
+
+    /*!
+      @brief Checks, whether Power(Clock) of peripheral is enabled by AutoGate
+      @tparam <Peripheral> peripheral of the set
+    */
+    template<typename Peripheral>
+    __FORCE_INLINE static bool IsPowered(){
+      return _powered & _Bit<Peripheral>();
+    }
+
+  };
+
+  /*!
+    @brief Power(Clock) control, which is the only writer of registers with bits listed in 'OwnedList'. 
+      Register, whose owned bits are all determined by operation, is written without reading:
+      not owned bits are written with reset value. So not owned bits of these registers must never be set,
+      e.g. by enabling TIM2 clock outside Power, otherwise they are cleared.
+      E.g.: using AppPower = Power::Owned<Power::fromPeripherals<spi, uart>>;
+    @tparam <OwnedList> list of owned bits, with trait 'power'
+  */
+  template<typename OwnedList>
+  using Owned = typename _owned<OwnedList>::type;
+
+  /*!
+    @brief Creates custom 'power' list from peripherals. Peripheral driver should implement 'power' trait
+      and may implement 'dependencies' trait: Typelist of drivers, whose Power(Clock) it needs.
       E.g.: using power = Power::makeFromValues<1, 512, 8>::power; 
     @tparam <PeripheralsList> list of peripherals with trait 'power'
   */
  template<typename... PeripheralsList>
   class fromPeripherals{
     fromPeripherals() = delete;
-    using power = utils::lists_termwise_or_t<typename PeripheralsList::power...>;
-    friend class IPower<adapter>;
+    using power = utils::lists_termwise_or_t<typename _power<PeripheralsList>::type...>;
+    using sleep_power = utils::lists_termwise_or_t<typename _sleepPower<PeripheralsList>::type...>;
+    using reset = utils::lists_termwise_or_t<typename _reset<PeripheralsList>::type...>;
+    using peripherals = utils::Typelist<PeripheralsList...>;
+    template<typename>
+    friend class IPower;
   };
 
 };
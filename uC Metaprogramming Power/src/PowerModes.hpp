@@ -0,0 +1,27 @@
+#ifndef _POWER_MODES_HPP
+#define _POWER_MODES_HPP
+
+#include "stm32f1_Power.hpp"
+#include "stm32f1_UART.hpp"
+#include "stm32f1_SPI.hpp"
+
+/*!
+  @brief Power states of application. Shared by main.cpp and power budget report (tools/power_report.cpp).
+    Drivers do not declare 'current': it depends on part and clocks, so application takes it
+    from datasheet, e.g.: struct spi: controller::SPI<2>{ static constexpr uint32_t current = ...; };
+*/
+
+using spi = controller::SPI<2>;
+using uart = controller::UART<1>;
+
+using listPowerInit = controller::Power::fromPeripherals<spi, uart>;
+using listPowerWake = controller::Power::fromPeripherals<uart>;
+
+using PowerModes = controller::Power::StateMachine<listPowerInit, listPowerWake>;
+
+/*!
+  @brief Names of states of 'PowerModes' for reports, in the same order
+*/
+constexpr const char* powerModesNames[] = {"listPowerInit", "listPowerWake"};
+
+#endif // !_POWER_MODES_HPP
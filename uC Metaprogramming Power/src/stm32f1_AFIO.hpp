@@ -0,0 +1,27 @@
+#ifndef _STM32F1_AFIO_HPP
+#define _STM32F1_AFIO_HPP
+
+#include "stm32f1_Power.hpp"
+
+namespace controller{
+
+/*!
+  @brief Alternate function I/O. Dependency of drivers with remapped pins or EXTI lines
+*/
+class AFIO{
+
+  static const uint32_t RCC_APB2ENR_AFIOEN = 1;
+
+  /*!
+    @brief Trait for using in Power class. Consists of Valueslist with
+      values for AHBENR, APB1ENR, APB2ENR registers 
+  */
+  using power = Power::fromValues<0U, 0U, RCC_APB2ENR_AFIOEN>::power;
+
+  template<typename>
+  friend class interfaces::IPower;
+};
+
+}
+
+#endif // !_STM32F1_AFIO_HPP
@@ -0,0 +1,164 @@
+#ifndef _STM32F1_CLOCK_HPP
+#define _STM32F1_CLOCK_HPP
+
+#include <algorithm>
+#include <cstdint>
+
+/*!
+  @brief Controller's peripherals
+*/
+namespace controller{
+
+/*!
+  @brief Buses, which clock peripherals
+*/
+enum class Bus{ AHB, APB1, APB2 };
+
+/*!
+  @brief Minimal frequency of the bus, which is required by peripheral.
+    Peripheral may derive own requirement and hide 'IsSatisfied', e.g. to limit error of baudrate.
+    E.g.: using requirement = ClockRequirement<Bus::APB2, 16 * 115200>;
+  @tparam <bus> bus of peripheral
+  @tparam <frequency> minimal frequency of the bus, Hz
+*/
+template<Bus bus, uint32_t frequency>
+struct ClockRequirement{
+  ClockRequirement() = delete;
+  static constexpr Bus requiredBus = bus;
+  static constexpr uint32_t requiredFrequency = frequency;
+
+  static constexpr bool IsSatisfied(uint32_t busFrequency){
+    return busFrequency >= frequency;
+  }
+};
+
+namespace{
+
+/*
+  Limits of the clock tree and encoding of prescalers in RCC_CFGR
+*/
+struct clock_limits{
+
+  static constexpr uint32_t maxHCLK = 72000000, maxPCLK1 = 36000000, maxPCLK2 = 72000000;
+
+  static constexpr uint32_t Log2(uint32_t value){
+    uint32_t result = 0;
+    for(; value > 1; value /= 2)
+      ++result;
+    return result;
+  }
+
+  static constexpr bool IsAHBDivider(uint32_t divider){
+    return divider && divider != 32 && divider <= 512 && !(divider & (divider - 1));
+  }
+
+  static constexpr bool IsAPBDivider(uint32_t divider){
+    return divider && divider <= 16 && !(divider & (divider - 1));
+  }
+
+  static constexpr uint32_t AHBCode(uint32_t divider){
+    return divider == 1 ? 0 : 0x8 | (Log2(divider) - (divider > 16 ? 2 : 1));
+  }
+
+  static constexpr uint32_t APBCode(uint32_t divider){
+    return divider == 1 ? 0 : 0x4 | (Log2(divider) - 1);
+  }
+
+};
+
+}
+
+/*!
+  @brief Clock tree: SYSCLK divided by AHB prescaler, then by APB1 and APB2 prescalers.
+    E.g.: using clock = Clock<72000000, 1, 2, 1>;
+          constexpr auto brr = UART<1>::brr<clock, 115200>;
+  @tparam <sysclk> SYSCLK frequency, Hz
+  @tparam <ahbDivider=1> AHB prescaler: 1, 2, 4, 8, 16, 64, 128, 256, 512
+  @tparam <apb1Divider=1> APB1 prescaler: 1, 2, 4, 8, 16
+  @tparam <apb2Divider=1> APB2 prescaler: 1, 2, 4, 8, 16
+*/
+template<uint32_t sysclk, uint32_t ahbDivider = 1, uint32_t apb1Divider = 1, uint32_t apb2Divider = 1>
+class Clock{
+
+  Clock() = delete;
+
+  using limits = clock_limits;
+
+  static_assert(limits::IsAHBDivider(ahbDivider), "AHB prescaler must be 1, 2, 4, 8, 16, 64, 128, 256 or 512");
+  static_assert(limits::IsAPBDivider(apb1Divider) && limits::IsAPBDivider(apb2Divider), 
+                "APB prescaler must be 1, 2, 4, 8 or 16");
+  static_assert(sysclk / ahbDivider <= limits::maxHCLK, "HCLK exceeds 72 MHz");
+  static_assert(sysclk / ahbDivider / apb1Divider <= limits::maxPCLK1, "PCLK1 exceeds 36 MHz");
+  static_assert(sysclk / ahbDivider / apb2Divider <= limits::maxPCLK2, "PCLK2 exceeds 72 MHz");
+
+public:
+
+  static constexpr uint32_t SYSCLK = sysclk;
+  static constexpr uint32_t HCLK = sysclk / ahbDivider;
+  static constexpr uint32_t PCLK1 = HCLK / apb1Divider;
+  static constexpr uint32_t PCLK2 = HCLK / apb2Divider;
+
+  /*!
+    @brief Frequency of the bus, Hz
+    @tparam <bus> bus of peripheral
+  */
+  template<Bus bus>
+  static constexpr uint32_t frequency = bus == Bus::AHB ? HCLK : bus == Bus::APB1 ? PCLK1 : PCLK2;
+
+  /*!
+    @brief HPRE, PPRE1, PPRE2 fields of RCC_CFGR register
+  */
+  static constexpr uint32_t cfgrMask = 0x00003FF0;
+  static constexpr uint32_t cfgr = limits::AHBCode(ahbDivider) << 4 
+                                 | limits::APBCode(apb1Divider) << 8 
+                                 | limits::APBCode(apb2Divider) << 11;
+
+};
+
+/*!
+  @brief Clock tree with the largest APB prescalers, which satisfy all requirements.
+    Lower bus frequencies reduce dynamic power consumption of peripherals. 
+    HCLK is given, so CPU and DMA throughput is kept.
+    E.g.: using clock = LowestClock<72000000, 1, UART<1>::requirement<115200>, SPI<2>::requirement<9000000>>::type;
+  @tparam <sysclk> SYSCLK frequency, Hz
+  @tparam <ahbDivider> AHB prescaler: 1, 2, 4, 8, 16, 64, 128, 256, 512
+  @tparam <Requirements> list of 'ClockRequirement'
+*/
+template<uint32_t sysclk, uint32_t ahbDivider, typename... Requirements>
+class LowestClock{
+
+  LowestClock() = delete;
+
+  template<Bus bus>
+  static constexpr bool _IsSatisfied(uint32_t frequency){
+    return ((Requirements::requiredBus != bus || Requirements::IsSatisfied(frequency)) && ...);
+  }
+
+  static constexpr uint32_t _Largest(uint32_t frequency, uint32_t maxFrequency, bool (*isSatisfied)(uint32_t)){
+    uint32_t result = 0;
+    for(uint32_t divider = 1; divider <= 16; divider *= 2)
+      if(frequency / divider <= maxFrequency && isSatisfied(frequency / divider))
+        result = divider;
+    return result;
+  }
+
+  using limits = clock_limits;
+
+  static_assert(limits::IsAHBDivider(ahbDivider), "AHB prescaler must be 1, 2, 4, 8, 16, 64, 128, 256 or 512");
+
+  static constexpr uint32_t _hclk = sysclk / ahbDivider;
+  static constexpr uint32_t _apb1 = _Largest(_hclk, limits::maxPCLK1, _IsSatisfied<Bus::APB1>);
+  static constexpr uint32_t _apb2 = _Largest(_hclk, limits::maxPCLK2, _IsSatisfied<Bus::APB2>);
+
+  static_assert(_IsSatisfied<Bus::AHB>(_hclk), "Requirements of AHB can not be satisfied with this HCLK");
+  static_assert(_apb1 && _apb2, "Requirements of APB can not be satisfied with this HCLK");
+
+public:
+
+  using type = Clock<sysclk, ahbDivider, _apb1, _apb2>;
+
+};
+
+} // !namespace controller
+
+#endif // !_STM32F1_CLOCK_HPP
\ No newline at end of file
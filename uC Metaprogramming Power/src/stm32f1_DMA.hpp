@@ -0,0 +1,222 @@
+#ifndef _STM32F1_DMA_HPP
+#define _STM32F1_DMA_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "stm32f1_Power.hpp"
+#include "HRegisters.hpp"
+
+#define __FORCE_INLINE __attribute__((always_inline)) inline
+
+namespace controller{
+
+/*!
+  @brief DMA controller
+  @tparam <number> number of controller, e.g. DMA<1>
+*/
+template<auto number>
+class DMA{
+
+  static_assert(number == 1 || number == 2, "STM32F1 has DMA1 and DMA2");
+
+  static const uint32_t RCC_AHBENR_DMAxEN = 1U << (number - 1);
+
+  /*!
+    @brief Trait for using in Power class. Consists of Valueslist with
+      values for AHBENR, APB1ENR, APB2ENR registers 
+  */
+  using power = typename Power::fromValues<RCC_AHBENR_DMAxEN, 0U, 0U>::power;
+
+  template<typename>
+  friend class interfaces::IPower;
+};
+
+/*!
+  @brief Part of memory buffer, which is filled by DMA. Points directly to buffer, data is not copied.
+    'overrun' is set, if data was lost: block is empty then
+*/
+struct DMABlock{
+  const uint8_t* data;
+  std::size_t size;
+  bool overrun;
+};
+
+/*!
+  @brief DMA channel for byte streams between peripheral data register and memory
+  @tparam <number> number of controller
+  @tparam <channel> number of channel
+  @tparam <RegisterAccess> policy for registers reading and writing
+*/
+template<auto number, auto channel, typename RegisterAccess = hardware::DirectAccess>
+class DMAChannel{
+
+  static_assert((number == 1 && channel >= 1 && channel <= 7) || (number == 2 && channel >= 1 && channel <= 5),
+                "STM32F1 has DMA1 channels 1..7 and DMA2 channels 1..5");
+
+  DMAChannel() = delete;
+
+  static constexpr uint32_t 
+    _base = number == 1 ? 0x40020000 : 0x40020400,
+    _channelBase = _base + 0x08 + 0x14 * (channel - 1),
+    _flagsShift = 4 * (channel - 1);
+
+  static constexpr uint32_t 
+    DMA_ISR_TCIF = 2U << _flagsShift,
+    DMA_ISR_HTIF = 4U << _flagsShift,
+    DMA_IFCR_CGIF = 0xFU << _flagsShift;
+
+  using ISR   = hardware::Register<_base + 0x00>;
+  using IFCR  = hardware::Register<_base + 0x04>;
+  using CCR   = hardware::Register<_channelBase + 0x00>;
+  using CNDTR = hardware::Register<_channelBase + 0x04>;
+  using CPAR  = hardware::Register<_channelBase + 0x08>;
+  using CMAR  = hardware::Register<_channelBase + 0x0C>;
+
+  using CCR_EN   = hardware::Field<CCR, 0>;
+  using CCR_DIR  = hardware::Field<CCR, 4>;
+  using CCR_CIRC = hardware::Field<CCR, 5>;
+  using CCR_MINC = hardware::Field<CCR, 7>;
+
+  static inline const uint8_t* _buffer = nullptr;
+  static inline uint16_t _size = 0;
+
+  template<typename... Values>
+  __FORCE_INLINE static void _Start(uint32_t peripheral, const volatile void* memory, uint16_t size){
+    hardware::HRegisters<RegisterAccess>:: template Write<typename CCR_EN::template Value<0>>();
+    RegisterAccess:: template Write<IFCR::address>(DMA_IFCR_CGIF);
+    RegisterAccess:: template Write<CNDTR::address>(size);
+    RegisterAccess:: template Write<CPAR::address>(peripheral);
+    RegisterAccess:: template Write<CMAR::address>(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(memory)));
+    hardware::HRegisters<RegisterAccess>:: template 
+        Write<typename CCR_MINC::template Value<1>, Values..., typename CCR_EN::template Value<1>>();
+  }
+
+public:
+
+  /*!
+    @brief Controller of channel, for 'dependencies' trait
+  */
+  using controller = DMA<number>;
+
+  static constexpr auto controllerNumber = number;
+  static constexpr auto channelNumber = channel;
+
+  /*!
+    @brief Starts transfer from memory to peripheral. Buffer must stay valid until 'IsComplete'
+    @param [in] peripheral address of peripheral data register
+    @param [in] data buffer to transmit
+    @param [in] size number of bytes
+  */
+  __FORCE_INLINE static void Transmit(uint32_t peripheral, const uint8_t* data, uint16_t size){
+    _Start<typename CCR_DIR::template Value<1>>(peripheral, data, size);
+  }
+
+  /*!
+    @brief Starts circular receive from peripheral to double buffer: DMA fills halves in turn,
+      while application reads other half by 'Received'
+    @param [in] peripheral address of peripheral data register
+    @param [in] buffer buffer of two halves
+    @param [in] size size of buffer, bytes. Must be even
+  */
+  __FORCE_INLINE static void Receive(uint32_t peripheral, uint8_t* buffer, uint16_t size){
+    assert(size % 2 == 0 && "Size of double buffer must be even");
+    _buffer = buffer;
+    _size = size;
+    _Start<typename CCR_CIRC::template Value<1>>(peripheral, buffer, size);
+  }
+
+  /*!
+    @brief Half of receive buffer, which is filled since last call, or empty block.
+      If both halves are filled since last call, first half may be already overwritten by DMA,
+      so flags are cleared and empty block with 'overrun' is returned
+  */
+  static DMABlock Received(){
+    auto flags = RegisterAccess:: template Read<ISR::address>();
+    if ((flags & (DMA_ISR_HTIF | DMA_ISR_TCIF)) == (DMA_ISR_HTIF | DMA_ISR_TCIF)){
+      RegisterAccess:: template Write<IFCR::address>(DMA_ISR_HTIF | DMA_ISR_TCIF);
+      return {_buffer, 0, true};
+    }
+    if (flags & DMA_ISR_HTIF){
+      RegisterAccess:: template Write<IFCR::address>(DMA_ISR_HTIF);
+      return {_buffer, _size / 2U, false};
+    }
+    if (flags & DMA_ISR_TCIF){
+      RegisterAccess:: template Write<IFCR::address>(DMA_ISR_TCIF);
+      return {_buffer + _size / 2U, _size / 2U, false};
+    }
+    return {_buffer, 0, false};
+  }
+
+  /*!
+    @brief Checks completion of 'Transmit'
+  */
+  __FORCE_INLINE static bool IsComplete(){
+    return RegisterAccess:: template Read<CNDTR::address>() == 0;
+  }
+
+  __FORCE_INLINE static void Stop(){
+    hardware::HRegisters<RegisterAccess>:: template Write<typename CCR_EN::template Value<0>>();
+  }
+
+};
+
+namespace{
+
+template<typename Stream, typename = void>
+struct dma_streams{
+  using type = utils::Typelist<typename Stream::dma_rx, typename Stream::dma_tx>;
+};
+
+template<typename Stream>
+struct dma_streams<Stream, std::void_t<decltype(Stream::channelNumber)>>{
+  using type = utils::Typelist<Stream>;
+};
+
+template<typename List, typename... Streams>
+struct dma_channels{
+  using type = List;
+};
+
+template<typename List, typename Stream, typename... Streams>
+struct dma_channels<List, Stream, Streams...>{
+  using type = typename dma_channels<utils::concat_t<List, typename dma_streams<Stream>::type>, Streams...>::type;
+};
+
+template<typename List>
+struct dma_allocation;
+
+template<typename... Channels>
+struct dma_allocation<utils::Typelist<Channels...>>{
+
+  static constexpr bool IsUnique(){
+    constexpr unsigned ids[] = {0U, (Channels::controllerNumber * 8U + Channels::channelNumber)...};
+    for(std::size_t i = 1; i < sizeof(ids) / sizeof(ids[0]); ++i)
+      for(std::size_t j = 1; j < i; ++j)
+        if (ids[i] == ids[j])
+          return false;
+    return true;
+  }
+
+  static_assert(IsUnique(), "DMA channel is used by more than one stream");
+
+  using type = utils::Typelist<Channels...>;
+};
+
+}
+
+/*!
+  @brief List of DMA channels, which are used together. Fails compilation, if channel is used twice.
+    Driver is expanded to its channels 'dma_rx' and 'dma_tx', channel is taken as is.
+    E.g.: using Streams = DMAAllocation<spi, uart>; fails for SPI<1> and UART<3>, both use DMA1 channels 2 and 3
+  @tparam <Streams> drivers with 'dma_rx' and 'dma_tx' or single channels, e.g. SPI<2> or SPI<2>::dma_tx
+*/
+template<typename... Streams>
+using DMAAllocation = typename dma_allocation<typename dma_channels<utils::Typelist<>, Streams...>::type>::type;
+
+}
+
+#undef __FORCE_INLINE
+
+#endif // !_STM32F1_DMA_HPP
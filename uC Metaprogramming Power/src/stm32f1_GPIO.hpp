@@ -0,0 +1,31 @@
+#ifndef _STM32F1_GPIO_HPP
+#define _STM32F1_GPIO_HPP
+
+#include "stm32f1_Power.hpp"
+
+namespace controller{
+
+/*!
+  @brief General purpose I/O port
+  @tparam <port> letter of port, e.g. GPIO<'A'>
+*/
+template<auto port>
+class GPIO{
+
+  static_assert(port >= 'A' && port <= 'G', "STM32F1 has GPIO ports A..G");
+
+  static const uint32_t RCC_APB2ENR_IOPxEN = 4U << (port - 'A');
+
+  /*!
+    @brief Trait for using in Power class. Consists of Valueslist with
+      values for AHBENR, APB1ENR, APB2ENR registers 
+  */
+  using power = typename Power::fromValues<0U, 0U, RCC_APB2ENR_IOPxEN>::power;
+
+  template<typename>
+  friend class interfaces::IPower;
+};
+
+}
+
+#endif // !_STM32F1_GPIO_HPP
@@ -2,12 +2,9 @@
 #define _STM32F1_POWER_HPP
 
 #include <cstdint>
-#include "IPower.hpp"
-#include "HPower.hpp"
+#include "HPowerAdapter.hpp"
 #include "type_traits_custom.hpp"
 
-#define __FORCE_INLINE __attribute__((always_inline)) inline
-
 /*!
   @brief Controller's peripherals
 */
@@ -15,10 +12,17 @@ namespace controller{
 
 /*!
   @brief Power managment for controller
+  @tparam <RegisterAccess> policy for registers reading and writing.
+    E.g.: hardware::SimulatedAccess for host, hardware::MaskedAccess<> for interrupt-safe modification.
+    hardware::ShadowAccess<> writes from copy in RAM without reading registers.
+    RCC registers are in bit-band region, so single bits are written through alias by default
+  @tparam <OwnedList> list of bits for AHBENR, APB1ENR, APB2ENR registers, which are written only by Power.
+    Other bits of register with owned bits must stay at reset value
 */
-class Power: public interfaces::IPower<Power>, public hardware::HPower{
+template<typename RegisterAccess = hardware::BitBandAccess<>, typename OwnedList = utils::Valuelist<>>
+class BasicPower: public hardware::PowerAdapter<BasicPower, RegisterAccess, OwnedList>{
 
-  Power() = delete;
+  BasicPower() = delete;
 
 public:
 
@@ -42,19 +46,33 @@ private:
     _addressAPB2ENR = 0x40021018,
     _addressAPB1ENR = 0x4002101C;
   
-  using AddressesList = utils::Valuelist<_addressAHBENR, _addressAPB1ENR, _addressAPB2ENR>;
+  static constexpr uint32_t 
+    _defaultAHBENR  = 0x00000014,
+    _defaultAPB2ENR = 0x00000000,
+    _defaultAPB1ENR = 0x00000000;
+  
+  static constexpr uint32_t 
+    _addressAPB2RSTR = 0x4002100C,
+    _addressAPB1RSTR = 0x40021010;
 
-  template<typename EnableList, typename DisableList>
-  __FORCE_INLINE static void _Set(){
-    HPower:: template ModifyRegisters<EnableList, DisableList, AddressesList>();
-  }
+  /*
+    AHB has no reset register
+  */
+  static constexpr uint32_t _addressAHBRSTR = 0;
+  
+  using AddressesList = utils::Valuelist<_addressAHBENR, _addressAPB1ENR, _addressAPB2ENR>;
+  using DefaultList = utils::Valuelist<_defaultAHBENR, _defaultAPB1ENR, _defaultAPB2ENR>;
+  using ResetAddressesList = utils::Valuelist<_addressAHBRSTR, _addressAPB1RSTR, _addressAPB2RSTR>;
 
-  friend class IPower<Power>;
+  friend class hardware::PowerAdapter<BasicPower, RegisterAccess, OwnedList>;
 
 };
 
-} // !namespace controller
+/*!
+  @brief Power managment for target controller
+*/
+using Power = BasicPower<>;
 
-#undef __FORCE_INLINE
+} // !namespace controller
 
 #endif // !_STM32F1_POWER_HPP
\ No newline at end of file
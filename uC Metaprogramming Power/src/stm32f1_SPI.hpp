@@ -2,29 +2,182 @@
 #define _STM32F1_SPI_HPP
 
 #include "stm32f1_Power.hpp"
+#include "stm32f1_Clock.hpp"
+#include "stm32f1_DMA.hpp"
+#include "stm32f1_GPIO.hpp"
+#include "HRegisters.hpp"
+
+#define __FORCE_INLINE __attribute__((always_inline)) inline
 
 namespace controller{
 
-template<auto baseAddress>
+/*!
+  @brief Serial peripheral interface
+  @tparam <baseAddress> number of SPI, e.g. SPI<2>
+  @tparam <RegisterAccess> policy for registers reading and writing, e.g. hardware::SimulatedAccess for host
+*/
+template<auto baseAddress, typename RegisterAccess = hardware::DirectAccess>
 class SPI{
 
-  static const uint32_t RCC_AHBENR_DMA1EN = 1;
-  static const uint32_t RCC_APB2ENR_IOPBEN = 8;
-  static const uint32_t RCC_APB1ENR_SPI2EN = 0x4000;
+  static constexpr bool _isAPB2 = baseAddress == 1;
+
+  /*
+    SPI1EN is bit 12 of APB2ENR, SPI2EN and SPI3EN are bits 14 and 15 of APB1ENR. Reset bits have same positions
+  */
+  static constexpr uint32_t _enable = baseAddress == 1 ? 0x1000 : baseAddress == 2 ? 0x4000 : 0x8000;
 
   /*!
     @brief Trait for using in Power class. Consists of Valueslist with
       values for AHBENR, APB1ENR, APB2ENR registers 
   */
-  using power = Power::fromValues<
-                                  RCC_AHBENR_DMA1EN,
-                                  RCC_APB1ENR_SPI2EN, 
-                                  RCC_APB2ENR_IOPBEN>::power;
+  using power = typename Power::fromValues<
+                                  0U,
+                                  _isAPB2 ? 0U : _enable, 
+                                  _isAPB2 ? _enable : 0U>::power;
+
+  /*!
+    @brief Trait for using in Power class. Consists of Valueslist with
+      values for APB1RSTR, APB2RSTR registers. First value is not used 
+  */
+  using reset = typename Power::fromValues<0U, _isAPB2 ? 0U : _enable, _isAPB2 ? _enable : 0U>::power;
+
+  static constexpr Bus bus = _isAPB2 ? Bus::APB2 : Bus::APB1;
+
+  static constexpr uint32_t _Base(){
+    static_assert(baseAddress >= 1 && baseAddress <= 3, "STM32F1 has SPI1..SPI3");
+    constexpr uint32_t bases[] = {0x40013000, 0x40003800, 0x40003C00};
+    return bases[baseAddress - 1];
+  }
+
+  using CR1 = hardware::Register<_Base() + 0x00>;
+  using CR2 = hardware::Register<_Base() + 0x04>;
+  using DR  = hardware::Register<_Base() + 0x0C>;
+
+  /*
+    Request mapping: SPI1 - DMA1 channels 2/3, SPI2 - DMA1 channels 4/5, SPI3 - DMA2 channels 1/2
+  */
+  static constexpr unsigned _dma = baseAddress == 3 ? 2 : 1;
+  static constexpr unsigned _channelRx = baseAddress == 1 ? 2 : baseAddress == 2 ? 4 : 1;
+  static constexpr char _port = baseAddress == 1 ? 'A' : 'B';
+
+  /*!
+    @brief Trait for using in Power class. Drivers, whose Power(Clock) is needed: 
+      port of pins and DMA controller of streams
+  */
+  using dependencies = utils::Typelist<GPIO<_port>, DMA<_dma>>;
+
+  static constexpr uint32_t _Code(uint32_t busFrequency, uint32_t frequency){
+    uint32_t code = 0;
+    while(code < 7 && (busFrequency >> (code + 1)) > frequency)
+      ++code;
+    return code;
+  }
+
+  template<uint32_t busFrequency, uint32_t frequency>
+  static constexpr uint32_t _Prescaler(){
+    constexpr uint32_t code = _Code(busFrequency, frequency);
+    static_assert((busFrequency >> (code + 1)) <= frequency,
+                  "SCK exceeds 'frequency' even with bus clock divided by 256, bus clock must be lowered");
+    return code;
+  }
                                   
   template<typename>
   friend class interfaces::IPower;
+
+public:
+
+  /*!
+    @brief DMA channels of SPI. For checking by 'DMAAllocation'
+  */
+  using dma_rx = DMAChannel<_dma, _channelRx, RegisterAccess>;
+  using dma_tx = DMAChannel<_dma, _channelRx + 1, RegisterAccess>;
+
+  /*!
+    @brief Fields of configuration registers. E.g.: SPI<2>::CR1_BR::Value<3>
+  */
+  using CR1_CPHA     = hardware::Field<CR1, 0>;
+  using CR1_CPOL     = hardware::Field<CR1, 1>;
+  using CR1_MSTR     = hardware::Field<CR1, 2>;
+  using CR1_BR       = hardware::Field<CR1, 3, 3>;
+  using CR1_SPE      = hardware::Field<CR1, 6>;
+  using CR1_LSBFIRST = hardware::Field<CR1, 7>;
+  using CR1_SSI      = hardware::Field<CR1, 8>;
+  using CR1_SSM      = hardware::Field<CR1, 9>;
+  using CR1_RXONLY   = hardware::Field<CR1, 10>;
+  using CR1_DFF      = hardware::Field<CR1, 11>;
+  using CR1_CRCEN    = hardware::Field<CR1, 13>;
+  using CR1_BIDIOE   = hardware::Field<CR1, 14>;
+  using CR1_BIDIMODE = hardware::Field<CR1, 15>;
+  using CR2_RXDMAEN  = hardware::Field<CR2, 0>;
+  using CR2_TXDMAEN  = hardware::Field<CR2, 1>;
+  using CR2_SSOE     = hardware::Field<CR2, 2>;
+  using CR2_ERRIE    = hardware::Field<CR2, 5>;
+  using CR2_RXNEIE   = hardware::Field<CR2, 6>;
+  using CR2_TXEIE    = hardware::Field<CR2, 7>;
+
+  /*!
+    @brief Writes configuration registers without reading: one store per register.
+      Fields, which are not listed, take reset value. 
+      E.g.: spi::Configure<spi::CR1_MSTR::Value<1>, spi::CR1_BR::Value<3>, spi::CR1_SPE::Value<1>>();
+    @tparam <Values> values of fields of this SPI
+  */
+  template<typename... Values>
+  __FORCE_INLINE static void Configure(){
+    static_assert(((Values::address == CR1::address || Values::address == CR2::address) && ...),
+                  "Field is not a configuration field of this SPI");
+    hardware::HRegisters<RegisterAccess>:: template Write<Values...>();
+  }
+
+  /*!
+    @brief Starts transmit of buffer by DMA. Buffer must stay valid until 'IsTransmitted'
+    @param [in] data buffer to transmit
+    @param [in] size number of bytes
+  */
+  __FORCE_INLINE static void Transmit(const uint8_t* data, uint16_t size){
+    dma_tx::Transmit(DR::address, data, size);
+    hardware::HRegisters<RegisterAccess>:: template Modify<typename CR2_TXDMAEN:: template Value<1>>();
+  }
+
+  __FORCE_INLINE static bool IsTransmitted(){
+    return dma_tx::IsComplete();
+  }
+
+  /*!
+    @brief Starts continuous receive by DMA to double buffer. Data is taken by 'Received'
+    @param [in] buffer buffer of two halves
+    @param [in] size size of buffer, bytes. Must be even
+  */
+  __FORCE_INLINE static void Receive(uint8_t* buffer, uint16_t size){
+    dma_rx::Receive(DR::address, buffer, size);
+    hardware::HRegisters<RegisterAccess>:: template Modify<typename CR2_RXDMAEN:: template Value<1>>();
+  }
+
+  /*!
+    @brief Half of receive buffer, which is filled since last call, or empty block. Data is not copied.
+      If both halves are filled since last call, block is empty and 'overrun' is set
+  */
+  __FORCE_INLINE static DMABlock Received(){
+    return dma_rx::Received();
+  }
+
+  /*!
+    @brief Value of BR field of CR1 register: the highest SCK frequency, which does not exceed 'frequency'
+    @tparam <Clock> clock tree, e.g. Clock<72000000, 1, 2, 1>
+    @tparam <frequency> maximal SCK frequency, Hz
+  */
+  template<typename Clock, uint32_t frequency>
+  static constexpr uint32_t prescaler = _Prescaler<Clock::template frequency<bus>, frequency>();
+
+  /*!
+    @brief Requirement to bus frequency for SCK frequency. For using in LowestClock
+    @tparam <frequency> SCK frequency, Hz
+  */
+  template<uint32_t frequency>
+  using requirement = ClockRequirement<bus, 2 * frequency>;
 };
 
 }
 
+#undef __FORCE_INLINE
+
 #endif // !_STM32F1_SPI_HPP
\ No newline at end of file
@@ -2,29 +2,179 @@
 #define _STM32F1_UART_HPP
 
 #include "stm32f1_Power.hpp"
+#include "stm32f1_Clock.hpp"
+#include "stm32f1_DMA.hpp"
+#include "stm32f1_GPIO.hpp"
+#include "HRegisters.hpp"
+
+#define __FORCE_INLINE __attribute__((always_inline)) inline
 
 namespace controller{
 
-template<auto baseAddress>
+/*!
+  @brief Universal synchronous asynchronous receiver transmitter
+  @tparam <baseAddress> number of USART, e.g. UART<1>
+  @tparam <RegisterAccess> policy for registers reading and writing, e.g. hardware::SimulatedAccess for host
+*/
+template<auto baseAddress, typename RegisterAccess = hardware::DirectAccess>
 class UART{
 
-  static const uint32_t RCC_AHBENR_DMA1EN = 1;
-  static const uint32_t RCC_APB2ENR_IOPAEN = 4;
-  static const uint32_t RCC_APB2ENR_USART1EN = 0x4000;
+  static constexpr bool _isAPB2 = baseAddress == 1;
+
+  /*
+    USART1EN is bit 14 of APB2ENR, USART2EN and USART3EN are bits 17 and 18 of APB1ENR. Reset bits have same positions
+  */
+  static constexpr uint32_t _enable = baseAddress == 1 ? 0x4000 : baseAddress == 2 ? 0x20000 : 0x40000;
 
   /*!
     @brief Trait for using in Power class. Consists of Valueslist with
       values for AHBENR, APB1ENR, APB2ENR registers 
   */
-  using power = Power::fromValues<
-                                  RCC_AHBENR_DMA1EN,
-                                  0U, 
-                                  RCC_APB2ENR_USART1EN | RCC_APB2ENR_IOPAEN>::power;
+  using power = typename Power::fromValues<
+                                  0U,
+                                  _isAPB2 ? 0U : _enable, 
+                                  _isAPB2 ? _enable : 0U>::power;
+
+  /*!
+    @brief Trait for using in Power class. Consists of Valueslist with
+      values for APB1RSTR, APB2RSTR registers. First value is not used 
+  */
+  using reset = typename Power::fromValues<0U, _isAPB2 ? 0U : _enable, _isAPB2 ? _enable : 0U>::power;
+
+  static constexpr Bus bus = _isAPB2 ? Bus::APB2 : Bus::APB1;
+
+  static constexpr uint32_t _Base(){
+    static_assert(baseAddress >= 1 && baseAddress <= 3, "STM32F1 has USART1..USART3");
+    constexpr uint32_t bases[] = {0x40013800, 0x40004400, 0x40004800};
+    return bases[baseAddress - 1];
+  }
+
+  using BRR = hardware::Register<_Base() + 0x08>;
+  using CR1 = hardware::Register<_Base() + 0x0C>;
+  using CR2 = hardware::Register<_Base() + 0x10>;
+  using CR3 = hardware::Register<_Base() + 0x14>;
+  using DR  = hardware::Register<_Base() + 0x04>;
+
+  /*
+    Request mapping: USART1 - DMA1 channels 5/4, USART2 - DMA1 channels 6/7, USART3 - DMA1 channels 3/2
+  */
+  static constexpr unsigned _channelRx = baseAddress == 1 ? 5 : baseAddress == 2 ? 6 : 3;
+  static constexpr unsigned _channelTx = baseAddress == 1 ? 4 : baseAddress == 2 ? 7 : 2;
+  static constexpr char _port = baseAddress == 3 ? 'B' : 'A';
+
+  /*!
+    @brief Trait for using in Power class. Drivers, whose Power(Clock) is needed: 
+      port of pins and DMA controller of streams
+  */
+  using dependencies = utils::Typelist<GPIO<_port>, DMA<1>>;
+
+  static constexpr uint32_t _ErrorPermille(uint32_t busFrequency, uint32_t baudrate){
+    uint64_t divider = (busFrequency + baudrate / 2) / baudrate;
+    uint64_t frequency = divider * baudrate;
+    uint64_t difference = frequency > busFrequency ? frequency - busFrequency : busFrequency - frequency;
+    return static_cast<uint32_t>(difference * 1000 / frequency);
+  }
                                   
   template<typename>
   friend class interfaces::IPower;
+
+public:
+
+  /*!
+    @brief DMA channels of UART. For checking by 'DMAAllocation'
+  */
+  using dma_rx = DMAChannel<1, _channelRx, RegisterAccess>;
+  using dma_tx = DMAChannel<1, _channelTx, RegisterAccess>;
+
+  /*!
+    @brief Fields of configuration registers. E.g.: UART<1>::CR1_TE::Value<1>
+  */
+  using BRR_BRR      = hardware::Field<BRR, 0, 16>;
+  using CR1_RE       = hardware::Field<CR1, 2>;
+  using CR1_TE       = hardware::Field<CR1, 3>;
+  using CR1_IDLEIE   = hardware::Field<CR1, 4>;
+  using CR1_RXNEIE   = hardware::Field<CR1, 5>;
+  using CR1_TCIE     = hardware::Field<CR1, 6>;
+  using CR1_TXEIE    = hardware::Field<CR1, 7>;
+  using CR1_PS       = hardware::Field<CR1, 9>;
+  using CR1_PCE      = hardware::Field<CR1, 10>;
+  using CR1_M        = hardware::Field<CR1, 12>;
+  using CR1_UE       = hardware::Field<CR1, 13>;
+  using CR2_STOP     = hardware::Field<CR2, 12, 2>;
+  using CR3_DMAR     = hardware::Field<CR3, 6>;
+  using CR3_DMAT     = hardware::Field<CR3, 7>;
+
+  /*!
+    @brief Writes configuration registers without reading: one store per register.
+      Fields, which are not listed, take reset value. 
+      E.g.: uart::Configure<uart::BRR_BRR::Value<uart::brr<Clock, 115200>>, uart::CR1_TE::Value<1>>();
+    @tparam <Values> values of fields of this UART
+  */
+  template<typename... Values>
+  __FORCE_INLINE static void Configure(){
+    static_assert(((Values::address == BRR::address || Values::address == CR1::address ||
+                    Values::address == CR2::address || Values::address == CR3::address) && ...),
+                  "Field is not a configuration field of this UART");
+    hardware::HRegisters<RegisterAccess>:: template Write<Values...>();
+  }
+
+  /*!
+    @brief Starts transmit of buffer by DMA. Buffer must stay valid until 'IsTransmitted'
+    @param [in] data buffer to transmit
+    @param [in] size number of bytes
+  */
+  __FORCE_INLINE static void Transmit(const uint8_t* data, uint16_t size){
+    dma_tx::Transmit(DR::address, data, size);
+    hardware::HRegisters<RegisterAccess>:: template Modify<typename CR3_DMAT:: template Value<1>>();
+  }
+
+  __FORCE_INLINE static bool IsTransmitted(){
+    return dma_tx::IsComplete();
+  }
+
+  /*!
+    @brief Starts continuous receive by DMA to double buffer. Data is taken by 'Received'
+    @param [in] buffer buffer of two halves
+    @param [in] size size of buffer, bytes. Must be even
+  */
+  __FORCE_INLINE static void Receive(uint8_t* buffer, uint16_t size){
+    dma_rx::Receive(DR::address, buffer, size);
+    hardware::HRegisters<RegisterAccess>:: template Modify<typename CR3_DMAR:: template Value<1>>();
+  }
+
+  /*!
+    @brief Half of receive buffer, which is filled since last call, or empty block. Data is not copied.
+      If both halves are filled since last call, block is empty and 'overrun' is set
+  */
+  __FORCE_INLINE static DMABlock Received(){
+    return dma_rx::Received();
+  }
+
+  /*!
+    @brief Value of BRR register for baudrate, rounded to the nearest
+    @tparam <Clock> clock tree, e.g. Clock<72000000, 1, 2, 1>
+    @tparam <baudrate> baudrate, bit/s
+  */
+  template<typename Clock, uint32_t baudrate>
+  static constexpr uint32_t brr = (Clock::template frequency<bus> + baudrate / 2) / baudrate;
+
+  /*!
+    @brief Requirement to bus frequency for baudrate: BRR fits in 16 bits and error of baudrate
+      after rounding of BRR is limited. For using in LowestClock
+    @tparam <baudrate> baudrate, bit/s
+    @tparam <errorPermille=10> maximal error of baudrate, 1/1000
+  */
+  template<uint32_t baudrate, uint32_t errorPermille = 10>
+  struct requirement: ClockRequirement<bus, 16 * baudrate>{
+    static constexpr bool IsSatisfied(uint32_t busFrequency){
+      return busFrequency >= 16 * baudrate && busFrequency / baudrate <= 0xFFFF &&
+             _ErrorPermille(busFrequency, baudrate) <= errorPermille;
+    }
+  };
 };
 
 }
 
+#undef __FORCE_INLINE
+
 #endif // !_STM32F1_UART_HPP
\ No newline at end of file
@@ -0,0 +1,224 @@
+#ifndef _STM32F1_WAKE_HPP
+#define _STM32F1_WAKE_HPP
+
+#include <cstdint>
+#include "stm32f1_Clock.hpp"
+#include "HRegisterAccess.hpp"
+#include "HRegisters.hpp"
+
+#define __FORCE_INLINE __attribute__((always_inline)) inline
+
+namespace controller{
+
+/*!
+  @brief Steps of wake sequence, which are committed in order.
+    E.g.: using Early = WakeSteps<Power::Transaction<>::Enable<uart>, UartSetup>;
+  @tparam <Steps> types with static 'Commit()', e.g. Power::Transaction
+*/
+template<typename... Steps>
+struct WakeSteps{
+
+  WakeSteps() = delete;
+
+  __FORCE_INLINE static void Commit(){
+    (Steps::Commit(), ...);
+  }
+
+};
+
+/*!
+  @brief Wake sequence after Stop mode, which does not wait for oscillators.
+    'Start' turns HSE on and commits 'Early' steps, while HSE and PLL are settling.
+    'Poll' advances sequence on ready flags and commits 'Late' steps, when SYSCLK is switched.
+    Flash latency for SYSCLK is set by 'Start', before SYSCLK is switched: wait states are safe for HSI.
+    Steps, which depend on bus frequencies (e.g. baudrate), must be 'Late'.
+    E.g.: using Wake = WakeSequencer<clock, 8000000, Early, Late>;
+          Wake::Start();
+          while(!Wake::Poll()) { DoOtherWork(); }
+  @tparam <Clock> clock tree after wake, e.g. Clock<72000000, 1, 2, 1>
+  @tparam <hseFrequency> HSE frequency, Hz. If it equals SYSCLK, PLL is not used
+  @tparam <Early> steps, which do not depend on SYSCLK, with static 'Commit()'
+  @tparam <Late> steps, which depend on SYSCLK, with static 'Commit()'
+  @tparam <RegisterAccess> policy for registers reading and writing, e.g. SimulatedRCC for host
+*/
+template<typename Clock, uint32_t hseFrequency, typename Early, typename Late,
+         typename RegisterAccess = hardware::DirectAccess>
+class WakeSequencer{
+
+  WakeSequencer() = delete;
+
+  static constexpr bool _usePLL = Clock::SYSCLK != hseFrequency;
+  static constexpr uint32_t _multiplier = Clock::SYSCLK / hseFrequency;
+  static constexpr uint32_t _latency = Clock::SYSCLK <= 24000000 ? 0 : Clock::SYSCLK <= 48000000 ? 1 : 2;
+
+  static_assert(!_usePLL || (Clock::SYSCLK % hseFrequency == 0 && _multiplier >= 2 && _multiplier <= 16),
+                "SYSCLK must be HSE multiplied by 2..16");
+
+  using CR   = hardware::Register<0x40021000, 0x00000083>;
+  using CFGR = hardware::Register<0x40021004>;
+  using ACR  = hardware::Register<0x40022000, 0x00000030>;
+
+  using CR_HSEON     = hardware::Field<CR, 16>;
+  using CR_HSERDY    = hardware::Field<CR, 17>;
+  using CR_PLLON     = hardware::Field<CR, 24>;
+  using CR_PLLRDY    = hardware::Field<CR, 25>;
+  using CFGR_SW      = hardware::Field<CFGR, 0, 2>;
+  using CFGR_SWS     = hardware::Field<CFGR, 2, 2>;
+  using CFGR_PRE     = hardware::Field<CFGR, 4, 10>;
+  using CFGR_PLLSRC  = hardware::Field<CFGR, 16>;
+  using CFGR_PLLMUL  = hardware::Field<CFGR, 18, 4>;
+  using ACR_LATENCY  = hardware::Field<ACR, 0, 3>;
+
+  static constexpr uint32_t _source = _usePLL ? 2 : 1;
+
+  using tRegisters = hardware::HRegisters<RegisterAccess>;
+
+public:
+
+  enum class State : uint8_t { Idle, StartingHSE, StartingPLL, Switching, Ready };
+
+  /*!
+    @brief Sets flash latency, turns HSE on, configures prescalers and PLL and commits 'Early' steps
+  */
+  static void Start(){
+    tRegisters:: template Modify<typename ACR_LATENCY:: template Value<_latency>>();
+    tRegisters:: template Modify<typename CR_HSEON:: template Value<1>>();
+    tRegisters:: template Modify<typename CFGR_PRE:: template Value<(Clock::cfgr >> 4)>,
+                                 typename CFGR_PLLSRC:: template Value<_usePLL ? 1 : 0>,
+                                 typename CFGR_PLLMUL:: template Value<_usePLL ? _multiplier - 2 : 0>>();
+    _state = State::StartingHSE;
+    Early::Commit();
+  }
+
+  /*!
+    @brief Advances sequence, if oscillator is ready. Does not wait
+    @return true, if SYSCLK is switched and 'Late' steps are committed
+  */
+  static bool Poll(){
+    auto control = RegisterAccess:: template Read<CR::address>();
+    switch(_state){
+      case State::StartingHSE:
+        if (!(control & CR_HSERDY::mask))
+          break;
+        if constexpr(_usePLL){
+          tRegisters:: template Modify<typename CR_PLLON:: template Value<1>>();
+          _state = State::StartingPLL;
+          break;
+        }
+        [[fallthrough]];
+      case State::StartingPLL:
+        if (_usePLL && !(control & CR_PLLRDY::mask))
+          break;
+        tRegisters:: template Modify<typename CFGR_SW:: template Value<_source>>();
+        _state = State::Switching;
+        [[fallthrough]];
+      case State::Switching:
+        if ((RegisterAccess:: template Read<CFGR::address>() & CFGR_SWS::mask) != (_source << 2))
+          break;
+        Late::Commit();
+        _state = State::Ready;
+        break;
+      default:
+        break;
+    }
+    return _state == State::Ready;
+  }
+
+  static State GetState(){
+    return _state;
+  }
+
+private:
+
+  static inline State _state = State::Idle;
+
+};
+
+namespace hardware{
+
+/*!
+  @brief Register access policy for host, which simulates oscillators of RCC: ready flags of HSE and PLL
+    are set after delay since they are turned on, SWS follows SW, when source is ready.
+    Time is advanced by 'Advance'. Other registers are simulated as by SimulatedAccess
+  @tparam <hseDelay> HSE startup time, ticks
+  @tparam <pllDelay> PLL lock time, ticks
+*/
+template<uint32_t hseDelay, uint32_t pllDelay>
+class SimulatedRCC: public SimulatedAccess{
+
+  SimulatedRCC() = delete;
+
+  static constexpr uint32_t
+    _addressCR   = 0x40021000,
+    _addressCFGR = 0x40021004;
+
+  static constexpr uint32_t
+    RCC_CR_HSEON  = 1U << 16,
+    RCC_CR_HSERDY = 1U << 17,
+    RCC_CR_PLLON  = 1U << 24,
+    RCC_CR_PLLRDY = 1U << 25;
+
+  static inline uint32_t _hseStart = 0;
+  static inline uint32_t _pllStart = 0;
+
+  static void _Update(){
+    auto& control = registers<_addressCR>;
+    bool isHSE = (control & RCC_CR_HSEON) && now - _hseStart >= hseDelay;
+    bool isPLL = isHSE && (control & RCC_CR_PLLON) && now - _pllStart >= pllDelay;
+    control = (control & ~(RCC_CR_HSERDY | RCC_CR_PLLRDY)) | (isHSE ? RCC_CR_HSERDY : 0) | (isPLL ? RCC_CR_PLLRDY : 0);
+
+    auto& configuration = registers<_addressCFGR>;
+    uint32_t source = configuration & 3;
+    bool isReady = source == 0 || (source == 1 && isHSE) || (source == 2 && isPLL);
+    if (isReady)
+      configuration = (configuration & ~0xCU) | (source << 2);
+  }
+
+public:
+
+  static inline uint32_t now = 0;
+
+  static void Advance(uint32_t ticks){
+    now += ticks;
+  }
+
+  template<auto address>
+  static auto Read(){
+    _Update();
+    return SimulatedAccess:: template Read<address>();
+  }
+
+  template<auto address>
+  static void Write(std::remove_const_t<decltype(address)> value){
+    if constexpr(address == _addressCR){
+      auto control = registers<_addressCR>;
+      if ((value & RCC_CR_HSEON) && !(control & RCC_CR_HSEON))
+        _hseStart = now;
+      if ((value & RCC_CR_PLLON) && !(control & RCC_CR_PLLON))
+        _pllStart = now;
+      value = (value & ~(RCC_CR_HSERDY | RCC_CR_PLLRDY)) | (control & (RCC_CR_HSERDY | RCC_CR_PLLRDY));
+    }
+    SimulatedAccess:: template Write<address>(value);
+    _Update();
+  }
+
+  template<auto address>
+  static void Modify(std::remove_const_t<decltype(address)> reset,
+                     std::remove_const_t<decltype(address)> set){
+    Write<address>((Read<address>() &(~reset)) | set);
+  }
+
+  template<auto address, auto reset, auto set>
+  static void ModifyBits(){
+    Modify<address>(reset, set);
+  }
+
+};
+
+} // !namespace hardware
+
+} // !namespace controller
+
+#undef __FORCE_INLINE
+
+#endif // !_STM32F1_WAKE_HPP
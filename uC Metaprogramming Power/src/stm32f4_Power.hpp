@@ -0,0 +1,111 @@
+#ifndef _STM32F4_POWER_HPP
+#define _STM32F4_POWER_HPP
+
+#include <cstdint>
+#include "HPowerAdapter.hpp"
+#include "type_traits_custom.hpp"
+
+/*!
+  @brief Controller's peripherals
+*/
+namespace controller{
+
+/*!
+  @brief Power managment for controller
+  @tparam <RegisterAccess> policy for registers reading and writing.
+    E.g.: hardware::SimulatedAccess for host, hardware::MaskedAccess<> for interrupt-safe modification.
+    hardware::ShadowAccess<> writes from copy in RAM without reading registers.
+    RCC registers are in bit-band region, so single bits are written through alias by default
+  @tparam <OwnedList> list of bits for AHB1ENR, AHB2ENR, AHB3ENR, APB1ENR, APB2ENR registers, 
+    which are written only by Power. Other bits of register with owned bits must stay at reset value
+*/
+template<typename RegisterAccess = hardware::BitBandAccess<>, typename OwnedList = utils::Valuelist<>>
+class BasicPower: public hardware::PowerAdapter<BasicPower, RegisterAccess, OwnedList>{
+
+  BasicPower() = delete;
+
+public:
+
+  /*!
+    @brief Creates custom 'power' list from values. Peripheral driver should implement 'power' trait.
+      E.g.: using power = Power::fromValues<1, 0, 0, 0x4000, 0>::power; 
+    @tparam <valueAHB1ENR=0> value for AHB1ENR register
+    @tparam <valueAHB2ENR=0> value for AHB2ENR register
+    @tparam <valueAHB3ENR=0> value for AHB3ENR register
+    @tparam <valueAPB1ENR=0> value for APB1ENR register
+    @tparam <valueAPB2ENR=0> value for APB2ENR register
+  */
+  template<uint32_t valueAHB1ENR = 0, uint32_t valueAHB2ENR = 0, uint32_t valueAHB3ENR = 0,
+           uint32_t valueAPB1ENR = 0, uint32_t valueAPB2ENR = 0>
+  struct fromValues{
+    fromValues() = delete;
+    using power = utils::Valuelist<valueAHB1ENR, valueAHB2ENR, valueAHB3ENR, valueAPB1ENR, valueAPB2ENR>;
+  };
+
+private: 
+
+  static constexpr uint32_t 
+    _addressAHB1ENR = 0x40023830,
+    _addressAHB2ENR = 0x40023834,
+    _addressAHB3ENR = 0x40023838,
+    _addressAPB1ENR = 0x40023840,
+    _addressAPB2ENR = 0x40023844;
+  
+  static constexpr uint32_t 
+    _defaultAHB1ENR = 0x00100000,
+    _defaultAHB2ENR = 0x00000000,
+    _defaultAHB3ENR = 0x00000000,
+    _defaultAPB1ENR = 0x00000000,
+    _defaultAPB2ENR = 0x00000000;
+  
+  static constexpr uint32_t 
+    _addressAHB1LPENR = 0x40023850,
+    _addressAHB2LPENR = 0x40023854,
+    _addressAHB3LPENR = 0x40023858,
+    _addressAPB1LPENR = 0x40023860,
+    _addressAPB2LPENR = 0x40023864;
+  
+  static constexpr uint32_t 
+    _defaultAHB1LPENR = 0x7E6791FF,
+    _defaultAHB2LPENR = 0x000000F1,
+    _defaultAHB3LPENR = 0x00000001,
+    _defaultAPB1LPENR = 0x36FEC9FF,
+    _defaultAPB2LPENR = 0x00075F33;
+  
+  /*
+    Sleep clocks of flash interface, SRAM1, SRAM2 and backup SRAM: core runs from them after wake-up
+  */
+  static constexpr uint32_t 
+    _keptAHB1LPENR = 0x00078000;
+  
+  static constexpr uint32_t 
+    _addressAHB1RSTR = 0x40023810,
+    _addressAHB2RSTR = 0x40023814,
+    _addressAHB3RSTR = 0x40023818,
+    _addressAPB1RSTR = 0x40023820,
+    _addressAPB2RSTR = 0x40023824;
+  
+  using AddressesList = utils::Valuelist<_addressAHB1ENR, _addressAHB2ENR, _addressAHB3ENR, 
+                                         _addressAPB1ENR, _addressAPB2ENR>;
+  using DefaultList = utils::Valuelist<_defaultAHB1ENR, _defaultAHB2ENR, _defaultAHB3ENR, 
+                                       _defaultAPB1ENR, _defaultAPB2ENR>;
+  using ResetAddressesList = utils::Valuelist<_addressAHB1RSTR, _addressAHB2RSTR, _addressAHB3RSTR, 
+                                             _addressAPB1RSTR, _addressAPB2RSTR>;
+  using SleepAddressesList = utils::Valuelist<_addressAHB1LPENR, _addressAHB2LPENR, _addressAHB3LPENR, 
+                                             _addressAPB1LPENR, _addressAPB2LPENR>;
+  using SleepDefaultList = utils::Valuelist<_defaultAHB1LPENR, _defaultAHB2LPENR, _defaultAHB3LPENR, 
+                                           _defaultAPB1LPENR, _defaultAPB2LPENR>;
+  using SleepKeptList = typename fromValues<_keptAHB1LPENR>::power;
+
+  friend class hardware::PowerAdapter<BasicPower, RegisterAccess, OwnedList>;
+
+};
+
+/*!
+  @brief Power managment for target controller
+*/
+using Power = BasicPower<>;
+
+} // !namespace controller
+
+#endif // !_STM32F4_POWER_HPP
\ No newline at end of file
@@ -0,0 +1,118 @@
+#ifndef _STM32L4_POWER_HPP
+#define _STM32L4_POWER_HPP
+
+#include <cstdint>
+#include "HPowerAdapter.hpp"
+#include "type_traits_custom.hpp"
+
+/*!
+  @brief Controller's peripherals
+*/
+namespace controller{
+
+/*!
+  @brief Power managment for controller
+  @tparam <RegisterAccess> policy for registers reading and writing.
+    E.g.: hardware::SimulatedAccess for host, hardware::MaskedAccess<> for interrupt-safe modification.
+    hardware::ShadowAccess<> writes from copy in RAM without reading registers.
+  @tparam <OwnedList> list of bits for AHB1ENR, AHB2ENR, AHB3ENR, APB1ENR1, APB1ENR2, APB2ENR registers, 
+    which are written only by Power. Other bits of register with owned bits must stay at reset value
+*/
+template<typename RegisterAccess = hardware::DirectAccess, typename OwnedList = utils::Valuelist<>>
+class BasicPower: public hardware::PowerAdapter<BasicPower, RegisterAccess, OwnedList>{
+
+  BasicPower() = delete;
+
+public:
+
+  /*!
+    @brief Creates custom 'power' list from values. Peripheral driver should implement 'power' trait.
+      E.g.: using power = Power::fromValues<1, 0, 0, 0x4000, 0, 0>::power; 
+    @tparam <valueAHB1ENR=0> value for AHB1ENR register
+    @tparam <valueAHB2ENR=0> value for AHB2ENR register
+    @tparam <valueAHB3ENR=0> value for AHB3ENR register
+    @tparam <valueAPB1ENR1=0> value for APB1ENR1 register
+    @tparam <valueAPB1ENR2=0> value for APB1ENR2 register
+    @tparam <valueAPB2ENR=0> value for APB2ENR register
+  */
+  template<uint32_t valueAHB1ENR = 0, uint32_t valueAHB2ENR = 0, uint32_t valueAHB3ENR = 0,
+           uint32_t valueAPB1ENR1 = 0, uint32_t valueAPB1ENR2 = 0, uint32_t valueAPB2ENR = 0>
+  struct fromValues{
+    fromValues() = delete;
+    using power = utils::Valuelist<valueAHB1ENR, valueAHB2ENR, valueAHB3ENR, 
+                                   valueAPB1ENR1, valueAPB1ENR2, valueAPB2ENR>;
+  };
+
+private: 
+
+  static constexpr uint32_t 
+    _addressAHB1ENR  = 0x40021048,
+    _addressAHB2ENR  = 0x4002104C,
+    _addressAHB3ENR  = 0x40021050,
+    _addressAPB1ENR1 = 0x40021058,
+    _addressAPB1ENR2 = 0x4002105C,
+    _addressAPB2ENR  = 0x40021060;
+  
+  static constexpr uint32_t 
+    _defaultAHB1ENR  = 0x00000100,
+    _defaultAHB2ENR  = 0x00000000,
+    _defaultAHB3ENR  = 0x00000000,
+    _defaultAPB1ENR1 = 0x00000000,
+    _defaultAPB1ENR2 = 0x00000000,
+    _defaultAPB2ENR  = 0x00000000;
+  
+  static constexpr uint32_t 
+    _addressAHB1SMENR  = 0x40021068,
+    _addressAHB2SMENR  = 0x4002106C,
+    _addressAHB3SMENR  = 0x40021070,
+    _addressAPB1SMENR1 = 0x40021078,
+    _addressAPB1SMENR2 = 0x4002107C,
+    _addressAPB2SMENR  = 0x40021080;
+  
+  static constexpr uint32_t 
+    _defaultAHB1SMENR  = 0x00011303,
+    _defaultAHB2SMENR  = 0x000532FF,
+    _defaultAHB3SMENR  = 0x00000101,
+    _defaultAPB1SMENR1 = 0xF2FECA3F,
+    _defaultAPB1SMENR2 = 0x00000025,
+    _defaultAPB2SMENR  = 0x01677C01;
+  
+  /*
+    Sleep clocks of flash interface, SRAM1 and SRAM2: core runs from them after wake-up
+  */
+  static constexpr uint32_t 
+    _keptAHB1SMENR = 0x00000300,
+    _keptAHB2SMENR = 0x00000200;
+  
+  static constexpr uint32_t 
+    _addressAHB1RSTR  = 0x40021028,
+    _addressAHB2RSTR  = 0x4002102C,
+    _addressAHB3RSTR  = 0x40021030,
+    _addressAPB1RSTR1 = 0x40021038,
+    _addressAPB1RSTR2 = 0x4002103C,
+    _addressAPB2RSTR  = 0x40021040;
+  
+  using AddressesList = utils::Valuelist<_addressAHB1ENR, _addressAHB2ENR, _addressAHB3ENR, 
+                                         _addressAPB1ENR1, _addressAPB1ENR2, _addressAPB2ENR>;
+  using DefaultList = utils::Valuelist<_defaultAHB1ENR, _defaultAHB2ENR, _defaultAHB3ENR, 
+                                       _defaultAPB1ENR1, _defaultAPB1ENR2, _defaultAPB2ENR>;
+  using ResetAddressesList = utils::Valuelist<_addressAHB1RSTR, _addressAHB2RSTR, _addressAHB3RSTR, 
+                                             _addressAPB1RSTR1, _addressAPB1RSTR2, _addressAPB2RSTR>;
+  using SleepAddressesList = utils::Valuelist<_addressAHB1SMENR, _addressAHB2SMENR, _addressAHB3SMENR, 
+                                             _addressAPB1SMENR1, _addressAPB1SMENR2, _addressAPB2SMENR>;
+  using SleepDefaultList = utils::Valuelist<_defaultAHB1SMENR, _defaultAHB2SMENR, _defaultAHB3SMENR, 
+                                           _defaultAPB1SMENR1, _defaultAPB1SMENR2, _defaultAPB2SMENR>;
+  using SleepKeptList = typename fromValues<_keptAHB1SMENR, _keptAHB2SMENR>::power;
+
+  friend class hardware::PowerAdapter<BasicPower, RegisterAccess, OwnedList>;
+
+};
+
+/*!
+  @brief Power managment for target controller
+*/
+using Power = BasicPower<>;
+
+} // !namespace controller
+
+#endif // !_STM32L4_POWER_HPP
\ No newline at end of file
@@ -1,7 +1,11 @@
 #ifndef _TYPE_TRAITS_CUSTOM_HPP
 #define _TYPE_TRAITS_CUSTOM_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <type_traits>
+#include <utility>
 
 /*!
   @file
@@ -167,6 +171,36 @@ using push_back_value_t = typename push_back_value<List, NewElement>::type;
 
 /*----------------------------------End of Push_Back------------------------------*/
 
+
+/*------------------------------------Concat----------------------------------------
+  Description:  Join elements of two lists to one list
+
+  using listOfTypes = Typelist<short, bool>;
+  using otherListOfTypes = Typelist<int, float>;
+
+  |-----------------------|--------------------------------------|------------------------------------|
+  |      Trait            |              Parameters              |               Result               |
+  |-----------------------|--------------------------------------|------------------------------------|
+  |       concat_t        |   <listOfTypes, otherListOfTypes>    | Typelist<short, bool, int, float>  |
+  |-----------------------|--------------------------------------|------------------------------------| */
+
+namespace{
+
+template<typename List, typename OtherList>
+struct concat;
+
+template<typename... List, typename... OtherList>
+struct concat<Typelist<List...>, Typelist<OtherList...>>{
+  using type = Typelist<List..., OtherList...>;
+};
+
+}
+
+template<typename List, typename OtherList>
+using concat_t = typename concat<List, OtherList>::type;
+
+/*--------------------------------End of Concat-----------------------------------*/
+
 /*-----------------------------------Is_Empty---------------------------------------
   Description:  Check parameters list for empty and return bool value
 
@@ -217,6 +251,37 @@ static constexpr auto is_empty_v = is_empty<List>::value;
 /*--------------------------------End of Is_Empty---------------------------------*/
 
 
+/*-----------------------------------Contains---------------------------------------
+  Description:  Check presence of the type in list and return bool value
+
+  using listOfTypes = Typelist<int, short, bool>;
+
+  |-------------------------|------------------------|----------|
+  |          Trait          |       Parameters       |  Result  |
+  |-------------------------|------------------------|----------|
+  |        contains_v       |  <listOfTypes, short>  |   true   |
+  |-------------------------|------------------------|----------|
+  |        contains_v       |  <listOfTypes, float>  |  false   |
+  |-------------------------|------------------------|----------| */
+
+namespace{
+
+template<typename List, typename Type>
+struct contains;
+
+template<typename... Types, typename Type>
+struct contains<Typelist<Types...>, Type>{
+  static constexpr bool value = (std::is_same_v<Types, Type> || ...);
+};
+
+}
+
+template<typename List, typename Type>
+static constexpr bool contains_v = contains<List, Type>::value;
+
+/*--------------------------------End of Contains---------------------------------*/
+
+
 /*---------------------------------Size_Of_List-------------------------------------
   Description:  Return number of elements in list
 
@@ -230,17 +295,17 @@ static constexpr auto is_empty_v = is_empty<List>::value;
 
 namespace{
 
-template<typename List, std::size_t count = 0U>
-struct size_of_list : public size_of_list<pop_front_t<List>, count + 1>{};
+template<typename List>
+struct size_of_list;
 
-template<std::size_t count>
-struct size_of_list<Typelist<>, count>{
-  static constexpr std::size_t value = count;
+template<typename... Types>
+struct size_of_list<Typelist<Types...>>{
+  static constexpr std::size_t value = sizeof...(Types);
 };
 
-template<std::size_t count>
-struct size_of_list<Valuelist<>, count>{
-  static constexpr std::size_t value = count;
+template<auto... Values>
+struct size_of_list<Valuelist<Values...>>{
+  static constexpr std::size_t value = sizeof...(Values);
 };
 
 }
@@ -269,96 +334,105 @@ static constexpr std::size_t size_of_list_v = size_of_list<List>::value;
 
 namespace{
 
-template<template <auto value1, auto value2> typename operation, 
-         typename List1, typename List2, typename Result = Valuelist<>>
-struct operation_2_termwise_valuelists{
-  constexpr static auto newValue = operation<front_v<List1>, front_v<List2>>::value;
-  using nextList1 = pop_front_t<List1>;
-  using nextList2 = pop_front_t<List2>;
-    
-  using result = push_back_value_t<Result, newValue>;
-  using type = typename 
-      operation_2_termwise_valuelists<operation, nextList1, nextList2, result>::type;
+/*
+  Type of values of list after operation, e.g. int for uint8_t. Fold over all values is taken,
+  only if values have different types: it is slow for long lists
+*/
+template<typename List>
+struct termwise_fold;
+
+template<auto... Values>
+struct termwise_fold<Valuelist<Values...>>{
+  using type = decltype((Values | ... | 0));
 };
 
-template<template <auto value1, auto value2> typename operation, typename Result>
-struct operation_2_termwise_valuelists<operation, Valuelist<>, Valuelist<>, Result>{
-  using type = Result;
+template<typename List>
+struct termwise_type{
+  using type = int;
 };
 
-template<template <auto value1, auto value2> typename operation, 
-         typename List2, typename Result>
-struct operation_2_termwise_valuelists<operation, Valuelist<>, List2, Result>{
-  using type = typename 
-      operation_2_termwise_valuelists<operation, Valuelist<0>, List2, Result>::type;
+template<auto First, auto... Values>
+struct termwise_type<Valuelist<First, Values...>>{
+  using type = typename std::conditional_t<
+      std::is_same_v<Valuelist<First, Values...>, Valuelist<First, static_cast<decltype(First)>(Values)...>>,
+      termwise_fold<Valuelist<First>>, termwise_fold<Valuelist<First, Values...>>>::type;
 };
 
-template<template <auto value1, auto value2> typename operation, 
-         typename List1, typename Result>
-struct operation_2_termwise_valuelists<operation, List1, Valuelist<>, Result>{
-  using type = typename 
-      operation_2_termwise_valuelists<operation, List1, Valuelist<0>, Result>::type;
+/*
+  Values of list as array. Lists are aligned to the longest one by zeros
+*/
+template<typename List>
+struct termwise_values;
+
+template<auto... Values>
+struct termwise_values<Valuelist<Values...>>{
+  using type = typename termwise_type<Valuelist<Values...>>::type;
+
+  /*
+    Merges values to 'result' by 'Operation'. The first list is copied
+  */
+  template<typename Operation, typename Result, std::size_t length>
+  static constexpr void merge(std::array<Result, length>& result, bool isFirst){
+    constexpr Result values[] = {static_cast<Result>(Values)..., Result{}};
+    for(std::size_t index = 0; index < length; ++index){
+      Result value = index < sizeof...(Values) ? values[index] : Result{};
+      result[index] = isFirst ? value : Operation::apply(result[index], value);
+    }
+  }
 };
 
+/*
+  Lists are merged into one array, which is built once per operation
+*/
+template<typename Operation, typename Result, std::size_t length, typename... Lists>
+constexpr std::array<Result, length> termwise_merge(){
+  std::array<Result, length> result{};
+  bool isFirst = true;
+  ((termwise_values<Lists>:: template merge<Operation>(result, isFirst), isFirst = false), ...);
+  return result;
+}
 
-template<template<typename first, typename second> class operation,
-         typename Lists, bool isEnd = size_of_list_v<Lists> == 1>
+template<typename Operation, typename... Lists>
 class lists_operation{
 
-  using first = front_t<Lists>;
-  using second = front_t<pop_front_t<Lists>>;
-  using next = pop_front_t<pop_front_t<Lists>>;
-  using result = operation<first, second>;
+  using value_t = decltype((typename termwise_values<Lists>::type{} | ... | 0));
+  static constexpr std::size_t length = std::max({std::size_t{0}, size_of_list_v<Lists>...});
+  static constexpr auto values = termwise_merge<Operation, value_t, length, Lists...>();
+
+  template<std::size_t... indices>
+  static Valuelist<values[indices]...> expand(std::index_sequence<indices...>);
 
 public:
 
-  using type = typename lists_operation<operation, push_front_t<next, result>>::type;
+  using type = decltype(expand(std::make_index_sequence<length>{}));
 
 };
 
-template<template<typename first, typename second> class operation,
-         typename Lists>
-class lists_operation<operation, Lists, true>{
-public:
-  using type = front_t<Lists>;
+struct and_operation{
+  template<typename... Values>
+  static constexpr auto apply(Values... values){ return (values & ...); }
 };
 
+struct or_operation{
+  template<typename... Values>
+  static constexpr auto apply(Values... values){ return (values | ...); }
+};
 
-template<auto value1, auto value2>
-struct and_operation{ static constexpr auto value = value1 & value2;};
-
-template<auto value1, auto value2>
-struct or_operation{ static constexpr auto value = value1 | value2;};
-
-template<auto value1, auto value2>
-struct xor_operation{ static constexpr auto value = value1 ^ value2;};
-
-
-template<typename List1, typename List2>
-using operation_and_termwise_t = typename 
-    operation_2_termwise_valuelists<and_operation, List1, List2>::type;
-
-template<typename List1, typename List2>
-using operation_or_termwise_t = typename 
-    operation_2_termwise_valuelists<or_operation, List1, List2>::type;
-
-template<typename List1, typename List2>
-using operation_xor_termwise_t = typename 
-    operation_2_termwise_valuelists<xor_operation, List1, List2>::type;
+struct xor_operation{
+  template<typename... Values>
+  static constexpr auto apply(Values... values){ return (values ^ ...); }
+};
 
 }
 
 template<typename... Lists>
-using lists_termwise_and_t = 
-    typename lists_operation<operation_and_termwise_t, Typelist<Lists...>>::type;
+using lists_termwise_and_t = typename lists_operation<and_operation, Lists...>::type;
 
 template<typename... Lists>
-using lists_termwise_or_t = typename 
-    lists_operation<operation_or_termwise_t, Typelist<Lists...>>::type;
+using lists_termwise_or_t = typename lists_operation<or_operation, Lists...>::type;
 
 template<typename... Lists>
-using lists_termwise_xor_t = typename 
-    lists_operation<operation_xor_termwise_t, Typelist<Lists...>>::type;
+using lists_termwise_xor_t = typename lists_operation<xor_operation, Lists...>::type;
 
 /*--------------------------------End of Lists Operation----------------------------*/
 
@@ -0,0 +1,244 @@
+/*
+  Host checks of Power adapters of STM32F4 and STM32L4 on simulated registers.
+  Adapters have the same name, so file is built once per family: -DCHECK_STM32F4 or -DCHECK_STM32L4.
+  Run by 'make check'
+*/
+
+#include <array>
+#include <cstdio>
+#include "HRegisterAccess.hpp"
+
+#if defined(CHECK_STM32F4)
+#include "stm32f4_Power.hpp"
+#elif defined(CHECK_STM32L4)
+#include "stm32l4_Power.hpp"
+#else
+#error "CHECK_STM32F4 or CHECK_STM32L4 must be defined"
+#endif
+
+using namespace controller;
+
+namespace{
+
+using Sim = hardware::SimulatedAccess;
+using FamilyPower = BasicPower<Sim>;
+
+template<auto... addresses>
+struct Registers{
+
+  static void Set(const std::array<uint32_t, sizeof...(addresses)>& values){
+    std::size_t index = 0;
+    ((Sim::registers<addresses> = values[index++]), ...);
+    Sim::Clear();
+  }
+
+  static std::array<uint32_t, sizeof...(addresses)> Get(){
+    return {Sim::registers<addresses>...};
+  }
+
+};
+
+#if defined(CHECK_STM32F4)
+
+constexpr const char* family = "STM32F4";
+
+// AHB1ENR, AHB2ENR, AHB3ENR, APB1ENR, APB2ENR
+using Enable = Registers<0x40023830U, 0x40023834U, 0x40023838U, 0x40023840U, 0x40023844U>;
+using Reset = Registers<0x40023810U, 0x40023814U, 0x40023818U, 0x40023820U, 0x40023824U>;
+using Sleep = Registers<0x40023850U, 0x40023854U, 0x40023858U, 0x40023860U, 0x40023864U>;
+using Zeros = std::array<uint32_t, 5>;
+
+constexpr uint32_t GPIOAEN = 0x1, DMA1EN = 0x200000, SPI2EN = 0x4000, USART1EN = 0x10;
+
+struct gpio{
+  using power = FamilyPower::fromValues<GPIOAEN>::power;
+};
+
+struct dma{
+  using power = FamilyPower::fromValues<DMA1EN>::power;
+};
+
+struct spi{
+  using power = FamilyPower::fromValues<0, 0, 0, SPI2EN, 0>::power;
+  using reset = power;
+  using dependencies = utils::Typelist<gpio, dma>;
+};
+
+struct uart{
+  using power = FamilyPower::fromValues<0, 0, 0, 0, USART1EN>::power;
+  using reset = power;
+  using dependencies = utils::Typelist<gpio, dma>;
+};
+
+constexpr Zeros enabled{GPIOAEN | DMA1EN, 0, 0, SPI2EN, USART1EN};
+constexpr Zeros uartOnly{GPIOAEN | DMA1EN, 0, 0, 0, USART1EN};
+constexpr Zeros defaults{0x00100000, 0, 0, 0, 0};
+constexpr Zeros sleepDefaults{0x7E6791FF, 0x000000F1, 0x00000001, 0x36FEC9FF, 0x00075F33};
+// FLITF, SRAM1, SRAM2, BKPSRAM
+constexpr Zeros sleepKept{0x00078000, 0, 0, 0, 0};
+
+#else
+
+constexpr const char* family = "STM32L4";
+
+// AHB1ENR, AHB2ENR, AHB3ENR, APB1ENR1, APB1ENR2, APB2ENR
+using Enable = Registers<0x40021048U, 0x4002104CU, 0x40021050U, 0x40021058U, 0x4002105CU, 0x40021060U>;
+using Reset = Registers<0x40021028U, 0x4002102CU, 0x40021030U, 0x40021038U, 0x4002103CU, 0x40021040U>;
+using Sleep = Registers<0x40021068U, 0x4002106CU, 0x40021070U, 0x40021078U, 0x4002107CU, 0x40021080U>;
+using Zeros = std::array<uint32_t, 6>;
+
+constexpr uint32_t DMA1EN = 0x1, GPIOAEN = 0x1, SPI2EN = 0x4000, USART1EN = 0x4000;
+
+struct gpio{
+  using power = FamilyPower::fromValues<0, GPIOAEN>::power;
+};
+
+struct dma{
+  using power = FamilyPower::fromValues<DMA1EN>::power;
+};
+
+struct spi{
+  using power = FamilyPower::fromValues<0, 0, 0, SPI2EN, 0, 0>::power;
+  using reset = power;
+  using dependencies = utils::Typelist<gpio, dma>;
+};
+
+struct uart{
+  using power = FamilyPower::fromValues<0, 0, 0, 0, 0, USART1EN>::power;
+  using reset = power;
+  using dependencies = utils::Typelist<gpio, dma>;
+};
+
+constexpr Zeros enabled{DMA1EN, GPIOAEN, 0, SPI2EN, 0, USART1EN};
+constexpr Zeros uartOnly{DMA1EN, GPIOAEN, 0, 0, 0, USART1EN};
+constexpr Zeros defaults{0x00000100, 0, 0, 0, 0, 0};
+constexpr Zeros sleepDefaults{0x00011303, 0x000532FF, 0x00000101, 0xF2FECA3F, 0x00000025, 0x01677C01};
+// FLASH, SRAM1, SRAM2
+constexpr Zeros sleepKept{0x00000300, 0x00000200, 0, 0, 0, 0};
+
+#endif
+
+int failures = 0;
+
+void Check(bool condition, const char* name){
+  if (!condition){
+    std::printf("FAIL: %s: %s\n", family, name);
+    ++failures;
+  }
+}
+
+void CheckAccesses(const char* name, std::size_t reads, std::size_t writes, std::size_t locks){
+  if (Sim::reads != reads || Sim::writes != writes || Sim::locks != locks){
+    std::printf("FAIL: %s: %s: reads %zu, writes %zu, locks %zu; expected %zu, %zu, %zu\n",
+                family, name, Sim::reads, Sim::writes, Sim::locks, reads, writes, locks);
+    ++failures;
+  }
+}
+
+/*
+  Number of registers with bits, DMA and GPIO share register on STM32F4 only
+*/
+constexpr std::size_t Count(const Zeros& values){
+  std::size_t count = 0;
+  for(auto value: values)
+    count += value != 0;
+  return count;
+}
+
+using listInit = FamilyPower::fromPeripherals<spi, uart>;
+using listUART = FamilyPower::fromPeripherals<uart>;
+
+void CheckOperations(){
+  Enable::Set({});
+  FamilyPower::Enable<listInit>();
+  CheckAccesses("Enable: changed registers only", Count(enabled), Count(enabled), 1);
+  Check(Enable::Get() == enabled, "Enable: bits of peripherals and dependencies");
+
+  Sim::Clear();
+  FamilyPower::DisableExcept<listInit, listUART>();
+  Check(Enable::Get() == uartOnly, "DisableExcept: shared bits are kept");
+
+  Reset::Set({});
+  FamilyPower::Reset<spi>();
+  CheckAccesses("Reset: stores only", 0, 2, 2);
+  Check(Reset::Get() == Zeros{}, "Reset: released");
+}
+
+void CheckStateMachine(){
+  using Modes = FamilyPower::StateMachine<listInit, listUART>;
+  Enable::Set(enabled);
+  Modes::Transition<listInit, listUART>();
+  CheckAccesses("Transition: register with delta only", 1, 1, 1);
+  Check(Enable::Get() == uartOnly, "Transition");
+
+  Sim::Clear();
+  Modes::Apply(0);
+  Check(Enable::Get() == enabled, "Apply");
+}
+
+void CheckOwned(){
+  using OwnedPower = FamilyPower::Owned<listInit>;
+  Enable::Set(defaults);
+  OwnedPower::Enable<uart>();
+  CheckAccesses("Owned: registers with all owned bits set are written without reading", 0, Count(uartOnly), 1);
+  Zeros expected = uartOnly;
+  expected[0] |= defaults[0];
+  Check(Enable::Get() == expected, "Owned: not owned bits keep reset value");
+}
+
+constexpr Zeros Or(const Zeros& left, const Zeros& right){
+  Zeros result{};
+  for(std::size_t i = 0; i < result.size(); ++i)
+    result[i] = left[i] | right[i];
+  return result;
+}
+
+constexpr Zeros Clear(const Zeros& left, const Zeros& right){
+  Zeros result{};
+  for(std::size_t i = 0; i < result.size(); ++i)
+    result[i] = left[i] & ~right[i];
+  return result;
+}
+
+void CheckSleep(){
+  Sleep::Set(sleepDefaults);
+  FamilyPower::DisableInSleep<spi, uart>();
+  Check(Sleep::Get() == Clear(sleepDefaults, enabled), "DisableInSleep: peripherals and dependencies");
+
+  Sim::Clear();
+  FamilyPower::EnableInSleep<uart>();
+  CheckAccesses("EnableInSleep: changed registers only", Count(uartOnly), Count(uartOnly), 1);
+  Check(Sleep::Get() == Or(Clear(sleepDefaults, enabled), uartOnly), "EnableInSleep");
+
+  Sleep::Set(sleepDefaults);
+  FamilyPower::SleepOnly<uart>();
+  CheckAccesses("SleepOnly: stores only", 0, sleepDefaults.size(), 1);
+  Check(Sleep::Get() == Or(uartOnly, sleepKept), "SleepOnly: memories and flash interface keep clock");
+}
+
+void CheckAutoGate(){
+  using Gate = FamilyPower::AutoGate<2, spi, uart, dma>;
+  Enable::Set({});
+  Gate::Use<spi>();
+  Gate::Use<uart>();
+  for(int tick = 0; tick < 3; ++tick){
+    Gate::Use<uart>();
+    Gate::Tick();
+  }
+  Check(!Gate::IsPowered<spi>() && Enable::Get() == uartOnly, "AutoGate: shared DMA is kept");
+}
+
+}
+
+int main(){
+  CheckOperations();
+  CheckStateMachine();
+  CheckOwned();
+  CheckSleep();
+  CheckAutoGate();
+  if (failures)
+    std::printf("%s: %d checks failed\n", family, failures);
+  else
+    std::printf("%s: all checks passed\n", family);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,402 @@
+/*
+  Host checks of register accesses of Power operations and drivers.
+  Registers are simulated by hardware::SimulatedAccess, so each check counts reads, writes and locks
+  of an operation and compares registers with expected values. Run by 'make check'
+*/
+
+#include <cstdio>
+#include <iterator>
+#include "stm32f1_Power.hpp"
+#include "stm32f1_SPI.hpp"
+#include "stm32f1_UART.hpp"
+#include "stm32f1_Wake.hpp"
+
+using namespace controller;
+
+namespace{
+
+using Sim = hardware::SimulatedAccess;
+
+constexpr uint32_t
+  addressAHBENR   = 0x40021014,
+  addressAPB2ENR  = 0x40021018,
+  addressAPB1ENR  = 0x4002101C,
+  addressAPB2RSTR = 0x4002100C,
+  addressAPB1RSTR = 0x40021010;
+
+int failures = 0;
+
+void Check(bool condition, const char* name){
+  if (!condition){
+    std::printf("FAIL: %s\n", name);
+    ++failures;
+  }
+}
+
+/*
+  Checks counters of accesses since last 'Sim::Clear'
+*/
+void CheckAccesses(const char* name, std::size_t reads, std::size_t writes, std::size_t locks){
+  if (Sim::reads != reads || Sim::writes != writes || Sim::locks != locks){
+    std::printf("FAIL: %s: reads %zu, writes %zu, locks %zu; expected %zu, %zu, %zu\n",
+                name, Sim::reads, Sim::writes, Sim::locks, reads, writes, locks);
+    ++failures;
+  }
+}
+
+void CheckRCC(const char* name, uint32_t ahb, uint32_t apb1, uint32_t apb2){
+  auto valueAHB = Sim::registers<addressAHBENR>;
+  auto valueAPB1 = Sim::registers<addressAPB1ENR>;
+  auto valueAPB2 = Sim::registers<addressAPB2ENR>;
+  if (valueAHB != ahb || valueAPB1 != apb1 || valueAPB2 != apb2){
+    std::printf("FAIL: %s: AHBENR %x, APB1ENR %x, APB2ENR %x; expected %x, %x, %x\n",
+                name, valueAHB, valueAPB1, valueAPB2, ahb, apb1, apb2);
+    ++failures;
+  }
+}
+
+void SetRCC(uint32_t ahb, uint32_t apb1, uint32_t apb2){
+  Sim::registers<addressAHBENR> = ahb;
+  Sim::registers<addressAPB1ENR> = apb1;
+  Sim::registers<addressAPB2ENR> = apb2;
+  Sim::Clear();
+}
+
+constexpr uint32_t
+  DMA1EN   = 0x0001,
+  IOPAEN   = 0x0004,
+  IOPBEN   = 0x0008,
+  ADC1EN   = 0x0200,
+  SPI2EN   = 0x4000,
+  USART1EN = 0x4000,
+  DMA2EN   = 0x0002,
+  SPI1EN   = 0x1000,
+  SPI3EN   = 0x8000,
+  USART2EN = 0x20000,
+  USART3EN = 0x40000;
+
+using spi = SPI<2>;
+using uart = UART<1>;
+
+struct adc{
+  using power = Power::fromValues<0U, 0U, ADC1EN>::power;
+};
+
+/*
+  LowestClock keeps HCLK and lowers APB clocks, while baudrate error stays in 1%:
+  PCLK2 = 2.25 MHz would give 112500 baud instead of 115200
+*/
+using lowestClock = LowestClock<72000000, 1, uart::requirement<115200>, spi::requirement<9000000>>::type;
+static_assert(lowestClock::HCLK == 72000000 && lowestClock::PCLK1 == 18000000 && lowestClock::PCLK2 == 4500000);
+static_assert(uart::brr<lowestClock, 115200> == 39);
+
+// SCK of SPI2 on PCLK1: 18 MHz / 2 and 36 MHz / 256
+static_assert(spi::prescaler<lowestClock, 9000000> == 0);
+static_assert(spi::prescaler<Clock<72000000, 1, 2, 1>, 140625> == 7);
+#if defined(SCK_TOO_LOW)
+static_assert(spi::prescaler<Clock<72000000, 1, 2, 1>, 100000> == 7);
+#endif
+
+using HostPower = BasicPower<Sim>;
+using listInit = HostPower::fromPeripherals<spi, uart>;
+using listSPI = HostPower::fromPeripherals<spi>;
+using listUART = HostPower::fromPeripherals<uart>;
+
+/*
+  Supply current: dependencies are counted, shared ones once. Figures of drivers are given by application
+*/
+struct loadDMA{
+  using power = Power::fromValues<DMA1EN, 0U, 0U>::power;
+  static constexpr uint32_t current = 10;
+};
+
+struct loadSPI{
+  using power = Power::fromValues<0U, SPI2EN, 0U>::power;
+  using dependencies = utils::Typelist<loadDMA>;
+  static constexpr uint32_t current = 100;
+};
+
+struct loadUART{
+  using power = Power::fromValues<0U, 0U, USART1EN>::power;
+  using dependencies = utils::Typelist<loadDMA>;
+  static constexpr uint32_t current = 200;
+};
+
+struct appSPI: SPI<2>{
+  static constexpr uint32_t current = 50;
+};
+
+static_assert(HostPower::current<loadSPI, loadUART> == 310);
+static_assert(HostPower::current<HostPower::fromPeripherals<loadSPI>, loadUART> == 310);
+static_assert(HostPower::StateMachine<HostPower::fromPeripherals<loadSPI, loadUART>,
+                                      HostPower::fromPeripherals<loadUART>>::currents[1] == 210);
+static_assert(HostPower::current<HostPower::fromPeripherals<appSPI>> == 50);
+
+/*
+  Operation in global constructor: copy of ShadowAccess is loaded on first access,
+  so SRAMEN and FLITFEN of AHBENR reset value are kept
+*/
+using EarlyPower = BasicPower<hardware::ShadowAccess<hardware::BitBandAccess<Sim>>>;
+uint32_t earlyAHBENR = 0;
+
+struct EarlyEnable{
+  EarlyEnable(){
+    Sim::registers<addressAHBENR> = 0x14;
+    EarlyPower::Enable<spi>();
+    earlyAHBENR = Sim::registers<addressAHBENR>;
+  }
+} earlyEnable;
+
+void CheckShadowAccess(){
+  Check(earlyAHBENR == (0x14 | DMA1EN), "ShadowAccess: copy is loaded before global constructors");
+
+  using ShadowPower = BasicPower<hardware::ShadowAccess<hardware::MaskedAccess<Sim>>>;
+  SetRCC(0, 0, 0);
+  ShadowPower::Enable<spi, uart>();
+#if defined(NDEBUG)
+  CheckAccesses("ShadowAccess: copy is loaded on first access", 3, 3, 1);
+#else
+  CheckAccesses("ShadowAccess: copy is loaded on first access", 6, 3, 1);
+#endif
+  Sim::Clear();
+  ShadowPower::Disable<spi>();
+#if defined(NDEBUG)
+  CheckAccesses("ShadowAccess: no reads", 0, 3, 1);
+#else
+  CheckAccesses("ShadowAccess: reads for comparison with copy only", 3, 3, 1);
+#endif
+  CheckRCC("ShadowAccess", 0, 0, IOPAEN | USART1EN);
+
+  // Single bits are written through alias, copy of register follows them
+  using BitBandPower = BasicPower<hardware::BitBandAccess<hardware::ShadowAccess<Sim>>>;
+  SetRCC(0, 0, 0);
+  BitBandPower::Enable<adc>();
+  BitBandPower::Enable<uart>();
+  CheckRCC("BitBandAccess of ShadowAccess", DMA1EN, 0, ADC1EN | IOPAEN | USART1EN);
+  Check(hardware::ShadowAccess<Sim>::Shadow<addressAPB2ENR>() == (ADC1EN | IOPAEN | USART1EN),
+        "BitBandAccess of ShadowAccess: alias write is applied to copy");
+}
+
+void CheckOperations(){
+  SetRCC(0, 0, 0);
+  HostPower::Enable<listInit>();
+  CheckAccesses("Enable", 3, 3, 1);
+  CheckRCC("Enable", DMA1EN, SPI2EN, IOPAEN | IOPBEN | USART1EN);
+  Check(Sim::journal[0].address == addressAHBENR && Sim::journal[0].operation == Sim::Operation::Read,
+        "Journal: registers are modified in order of addresses");
+
+  Sim::Clear();
+  Check(Sim::journal[0].address == 0, "Clear: journal is cleared");
+  HostPower::DisableExcept<listSPI, listUART>();
+  CheckAccesses("DisableExcept: shared DMA1 is not touched", 2, 2, 1);
+  CheckRCC("DisableExcept", DMA1EN, 0, IOPAEN | USART1EN);
+
+  Sim::Clear();
+  HostPower::Keep<listSPI, listUART>();
+  CheckAccesses("Keep", 2, 2, 1);
+  CheckRCC("Keep", DMA1EN, SPI2EN, IOPBEN);
+
+  Sim::Clear();
+  HostPower::DisableUnshared<listUART, spi>();
+  CheckAccesses("DisableUnshared", 2, 2, 1);
+  CheckRCC("DisableUnshared", DMA1EN, 0, 0);
+
+  SetRCC(0, 0, 0);
+  HostPower::Reset<spi, uart>();
+  CheckAccesses("Reset: stores only", 0, 4, 2);
+  Check(Sim::registers<addressAPB1RSTR> == 0 && Sim::registers<addressAPB2RSTR> == 0, "Reset: released");
+
+  SetRCC(0, 0, 0);
+  HostPower::EnableAndReset<spi, uart>();
+  CheckAccesses("EnableAndReset: assertion, enable and release under single lock", 3, 7, 1);
+  CheckRCC("EnableAndReset", DMA1EN, SPI2EN, IOPAEN | IOPBEN | USART1EN);
+  constexpr Sim::Record order[]{
+    {addressAPB2RSTR, USART1EN, Sim::Operation::Write}, {addressAPB1RSTR, SPI2EN, Sim::Operation::Write},
+    {addressAHBENR, 0, Sim::Operation::Read}, {addressAHBENR, DMA1EN, Sim::Operation::Write},
+    {addressAPB2ENR, 0, Sim::Operation::Read}, {addressAPB2ENR, IOPAEN | IOPBEN | USART1EN, Sim::Operation::Write},
+    {addressAPB1ENR, 0, Sim::Operation::Read}, {addressAPB1ENR, SPI2EN, Sim::Operation::Write},
+    {addressAPB2RSTR, 0, Sim::Operation::Write}, {addressAPB1RSTR, 0, Sim::Operation::Write}};
+  bool isOrdered = true;
+  for(std::size_t i = 0; i < std::size(order); ++i)
+    isOrdered &= Sim::journal[i].address == order[i].address && Sim::journal[i].value == order[i].value &&
+                 Sim::journal[i].operation == order[i].operation;
+  Check(isOrdered, "EnableAndReset: clocks are enabled while reset is asserted");
+
+  SetRCC(0, 0, 0);
+  HostPower::Enable<SPI<1>, SPI<3>, UART<2>, UART<3>>();
+  CheckRCC("Enable: clock bits follow instance number", DMA1EN | DMA2EN, SPI3EN | USART2EN | USART3EN,
+           IOPAEN | IOPBEN | SPI1EN);
+}
+
+void CheckStateMachine(){
+  using Modes = HostPower::StateMachine<listInit, listUART>;
+  SetRCC(DMA1EN, SPI2EN, IOPAEN | IOPBEN | USART1EN);
+  Modes::Transition<listInit, listInit>();
+  CheckAccesses("Transition to the same state", 0, 0, 0);
+
+  Modes::Transition<listInit, listUART>();
+  CheckAccesses("Transition: registers with changes only", 2, 2, 1);
+  CheckRCC("Transition", DMA1EN, 0, IOPAEN | USART1EN);
+
+  Sim::Clear();
+  Modes::Apply(0);
+  CheckAccesses("Apply", 3, 3, 1);
+  CheckRCC("Apply", DMA1EN, SPI2EN, IOPAEN | IOPBEN | USART1EN);
+
+  Sim::Clear();
+  Modes::Apply(2);
+  Modes::Apply(~std::size_t{0});
+  CheckAccesses("Apply: index out of range", 0, 0, 0);
+
+  using BitBandPower = BasicPower<hardware::BitBandAccess<Sim>>;
+  using BitBandModes = BitBandPower::StateMachine<listInit, listUART>;
+  Sim::Clear();
+  BitBandModes::Transition<listInit, listUART>();
+  CheckAccesses("Transition through bit-band alias: stores only", 0, 2, 1);
+  CheckRCC("Transition through bit-band alias", DMA1EN, 0, IOPAEN | USART1EN);
+}
+
+void CheckOwned(){
+  using OwnedPower = HostPower::Owned<listInit>;
+  SetRCC(0x14, 0, 0);
+  OwnedPower::Enable<spi, uart>();
+  CheckAccesses("Owned: all owned bits are determined", 0, 3, 1);
+  CheckRCC("Owned", 0x14 | DMA1EN, SPI2EN, IOPAEN | IOPBEN | USART1EN);
+
+  Sim::Clear();
+  OwnedPower::Disable<spi>();
+  CheckAccesses("Owned: APB2ENR is read, IOPAEN is not determined", 1, 3, 1);
+  CheckRCC("Owned: Disable", 0x14, 0, IOPAEN | USART1EN);
+}
+
+/*
+  ModifyRegisters with two entries of the same register: the second one has no changes,
+  but its owned bit must be kept by single store
+*/
+struct PlanPower: hardware::HPower<Sim>{
+  using HPower::ModifyRegisters;
+};
+
+void CheckWritePlan(){
+  using addresses = utils::Valuelist<addressAHBENR, addressAHBENR>;
+  SetRCC(2, 0, 0);
+  PlanPower::ModifyRegisters<utils::Valuelist<1U, 0U>, utils::Valuelist<0U, 0U>, addresses,
+                             utils::Valuelist<1U, 2U>, utils::Valuelist<0U, 0U>>();
+  CheckAccesses("Write plan: owned bit of entry without changes", 1, 1, 1);
+  Check(Sim::registers<addressAHBENR> == 3, "Write plan: owned bit of entry without changes is kept");
+}
+
+void CheckTransaction(){
+  SetRCC(0, 0, ADC1EN);
+  HostPower::Transaction<>::Enable<spi>::Enable<uart>::Disable<adc>::Commit();
+  CheckAccesses("Transaction: one modification per register", 3, 3, 1);
+  CheckRCC("Transaction", DMA1EN, SPI2EN, IOPAEN | IOPBEN | USART1EN);
+}
+
+void CheckAutoGate(){
+  using Gate = HostPower::AutoGate<3, spi, uart, DMA<1>>;
+  SetRCC(0, 0, 0);
+  Gate::Use<spi>();
+  Gate::Use<spi>();
+  CheckAccesses("AutoGate: enables once, counters under lock", 3, 3, 3);
+  for(int tick = 0; tick < 4; ++tick){
+    Gate::Use<uart>();
+    Gate::Tick();
+  }
+  Check(!Gate::IsPowered<spi>() && Gate::IsPowered<uart>(), "AutoGate: SPI is gated after 3 idle ticks");
+  CheckRCC("AutoGate: DMA1 is kept for UART, GPIO is not in the set", DMA1EN, 0, IOPAEN | IOPBEN | USART1EN);
+  for(int tick = 0; tick < 3; ++tick)
+    Gate::Tick();
+  Check(!Gate::IsPowered<uart>(), "AutoGate: UART is gated");
+  CheckRCC("AutoGate: DMA1 of the set is gated, GPIO is kept", 0, 0, IOPAEN | IOPBEN);
+}
+
+void CheckDMA(){
+  using hostSPI = SPI<2, Sim>;
+  using hostUART = UART<1, Sim>;
+  using Streams = DMAAllocation<hostSPI::dma_rx, hostUART::dma_rx>;
+  static_assert(utils::size_of_list_v<Streams> == 2);
+  // SPI2 uses DMA1 channels 4, 5 and UART2 channels 6, 7
+  static_assert(utils::size_of_list_v<DMAAllocation<SPI<2>, UART<2>>> == 4);
+#if defined(DMA_CONFLICT)
+  // SPI1 and UART3 both use DMA1 channels 2 and 3
+  using Conflict = DMAAllocation<SPI<1>, UART<3>>;
+#endif
+
+  constexpr uint32_t ISR = 0x40020000, CCR5 = 0x40020058, CNDTR5 = 0x4002005C, CPAR5 = 0x40020060;
+  static uint8_t tx[8];
+  static uint8_t rx[16];
+
+  Sim::Clear();
+  hostSPI::Transmit(tx, sizeof(tx));
+  Check(Sim::registers<CCR5> == 0x91 && Sim::registers<CNDTR5> == sizeof(tx) && Sim::registers<CPAR5> == 0x4000380C,
+        "SPI Transmit: DMA1 channel 5 is started from memory to DR");
+  Check(Sim::registers<0x40003804U> & 2, "SPI Transmit: TXDMAEN");
+  Check(!hostSPI::IsTransmitted(), "SPI Transmit: not complete");
+  Sim::registers<CNDTR5> = 0;
+  Check(hostSPI::IsTransmitted(), "SPI Transmit: complete");
+
+  hostUART::Receive(rx, sizeof(rx));
+  Check(Sim::registers<CCR5> == 0xA1 && Sim::registers<CNDTR5> == sizeof(rx) && Sim::registers<CPAR5> == 0x40013804,
+        "UART Receive: DMA1 channel 5 is started in circular mode");
+  Check(hostUART::Received().size == 0, "UART Received: nothing");
+  Sim::registers<ISR> = 4U << 16;
+  auto block = hostUART::Received();
+  Check(block.data == rx && block.size == sizeof(rx) / 2, "UART Received: first half");
+  Sim::registers<ISR> = 2U << 16;
+  block = hostUART::Received();
+  Check(block.data == rx + sizeof(rx) / 2 && block.size == sizeof(rx) / 2 && !block.overrun,
+        "UART Received: second half");
+  Sim::registers<ISR> = 6U << 16;
+  block = hostUART::Received();
+  Check(block.size == 0 && block.overrun && Sim::registers<0x40020004U> == 6U << 16,
+        "UART Received: both halves are filled, overrun and flags are cleared");
+  Sim::registers<ISR> = 0;
+}
+
+struct WakeLog{
+  static inline uint32_t early = ~0U;
+  static inline uint32_t late = ~0U;
+};
+
+template<typename Rcc>
+struct EarlyStep{
+  static void Commit(){ WakeLog::early = Rcc::now; }
+};
+
+template<typename Rcc>
+struct LateStep{
+  static void Commit(){ WakeLog::late = Rcc::now; }
+};
+
+void CheckWake(){
+  using Rcc = hardware::SimulatedRCC<50, 20>;
+  using Wake = WakeSequencer<Clock<72000000, 1, 2, 1>, 8000000, EarlyStep<Rcc>, LateStep<Rcc>, Rcc>;
+  Rcc::registers<0x40022000U> = 0x30;
+  Wake::Start();
+  Check(Rcc::registers<0x40022000U> == 0x32, "Wake: flash latency 2 for 72 MHz is set before SYSCLK switch");
+  while(!Wake::Poll())
+    Rcc::Advance(1);
+  Check(WakeLog::early == 0, "Wake: early steps overlap oscillators startup");
+  Check(WakeLog::late == 70, "Wake: late steps after HSE and PLL lock");
+  Check(Rcc::registers<0x40021004U> == 0x001D040A, "Wake: SYSCLK is PLL, PLLMUL 9, PCLK1 = HCLK / 2");
+}
+
+}
+
+int main(){
+  CheckShadowAccess();
+  CheckOperations();
+  CheckStateMachine();
+  CheckOwned();
+  CheckWritePlan();
+  CheckTransaction();
+  CheckAutoGate();
+  CheckDMA();
+  CheckWake();
+  if (failures)
+    std::printf("%d checks failed\n", failures);
+  else
+    std::printf("All checks passed\n");
+  return failures ? 1 : 0;
+}
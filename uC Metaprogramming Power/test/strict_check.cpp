@@ -0,0 +1,33 @@
+/*
+  Compile-only check of POWER_STRICT: operations, which leave no peripheral unpowered, must compile.
+  With STRICT_CONFLICT, Keep with common bits must fail. Built by 'make check' with -DPOWER_STRICT
+*/
+
+#include "stm32f1_Power.hpp"
+#include "stm32f1_SPI.hpp"
+#include "stm32f1_UART.hpp"
+
+using namespace controller;
+
+using spi = SPI<2>;
+using uart = UART<1>;
+
+using listInit = Power::fromPeripherals<spi, uart>;
+using listSPI = Power::fromPeripherals<spi>;
+using listUART = Power::fromPeripherals<uart>;
+
+void Strict(){
+  // Shared DMA1 stays enabled for UART
+  Power::DisableExcept<listSPI, listUART>();
+  Power::DisableExcept<listInit, listUART>();
+  Power::EnableExcept<Power::fromPeripherals<spi, uart, GPIO<'C'>>, GPIO<'C'>>();
+  Power::EnableExcept<listSPI, listUART>();
+  Power::Keep<GPIO<'A'>, GPIO<'B'>>();
+}
+
+#if defined(STRICT_CONFLICT)
+void Conflict(){
+  // DMA1 is common, so it is neither enabled nor disabled
+  Power::Keep<listSPI, listUART>();
+}
+#endif
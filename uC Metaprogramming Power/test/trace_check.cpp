@@ -0,0 +1,29 @@
+/*
+  Host check of POWER_TRACE: transitions of Power(Clock) registers are kept in trace,
+  while peripheral registers are written in between. Built and run by 'make check' with -DPOWER_TRACE
+*/
+
+#include <cstdio>
+#include "stm32f1_Power.hpp"
+#include "stm32f1_SPI.hpp"
+
+using namespace controller;
+
+using Sim = hardware::SimulatedAccess;
+using HostPower = BasicPower<Sim>;
+using spi = SPI<2, Sim>;
+
+int main(){
+  HostPower::Enable<spi>();
+  for(std::size_t i = 0; i < 2 * hardware::PowerTrace::capacity; ++i)
+    spi::Configure<spi::CR1_MSTR::Value<1>, spi::CR1_BR::Value<3>, spi::CR1_SPE::Value<1>>();
+  HostPower::Disable<spi>();
+
+  auto usage = HostPower::Profile<spi>(hardware::PowerTrace::Timestamp());
+  if (usage.transitions != 2){
+    std::printf("Trace: %zu transitions of SPI instead of 2\n", usage.transitions);
+    return 1;
+  }
+  std::printf("Trace check passed\n");
+  return 0;
+}
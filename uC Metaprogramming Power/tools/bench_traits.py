@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+"""
+Compile-time benchmark of traits from 'type_traits_custom.hpp'.
+
+Generates synthetic translation units with Valuelist/Typelist workloads of
+10, 100 and 1000 elements and 2..64 lists, compiles each of them with
+'-fsyntax-only' and prints CSV: compiler time and peak memory per workload.
+'baseline' is the header alone, so cost of workload is its time minus baseline.
+Termwise operations combine all lists at once. contains_v searches one Typelist
+'lists' times. push_back_value_t and pop_front_t are applied element by element
+to one list, so their memory grows as square of elements and 'lists' is 1.
+Compiler memory is limited, 4 GiB by default: workload, which exceeds the limit,
+is reported without time and the script exits with 1.
+
+  make bench
+  python3 tools/bench_traits.py --cxx clang++ --repeat 5 > bench.csv
+"""
+
+import argparse
+import os
+import resource
+import subprocess
+import sys
+import tempfile
+import time
+
+ELEMENTS = (10, 100, 1000)
+LISTS = (2, 4, 16, 64)
+
+HEADER = '#include "type_traits_custom.hpp"\n'
+
+
+def values(count, seed):
+    return ', '.join(f'{(seed * 131 + index * 7) & 0xFFFFFFFF}U' for index in range(count))
+
+
+def termwise(operation, elements, lists):
+    text = ''.join(f'using L{index} = utils::Valuelist<{values(elements, index)}>;\n' for index in range(lists))
+    arguments = ', '.join(f'L{index}' for index in range(lists))
+    text += f'using R = utils::lists_termwise_{operation}_t<{arguments}>;\n'
+    text += f'static_assert(utils::size_of_list_v<R> == {elements});\n'
+    return text
+
+
+def push_back(elements):
+    text = 'using L0 = utils::Valuelist<>;\n'
+    for index in range(elements):
+        text += f'using L{index + 1} = utils::push_back_value_t<L{index}, {index}U>;\n'
+    text += f'static_assert(utils::size_of_list_v<L{elements}> == {elements});\n'
+    return text
+
+
+def pop_front(elements):
+    text = f'using L0 = utils::Valuelist<{values(elements, 0)}>;\n'
+    for index in range(elements):
+        text += f'using L{index + 1} = utils::pop_front_t<L{index}>;\n'
+    text += f'static_assert(utils::is_empty_v<L{elements}>);\n'
+    return text
+
+
+def contains(elements, lists):
+    text = '#include <type_traits>\n'
+    types = ', '.join(f'std::integral_constant<unsigned, {index}>' for index in range(elements))
+    text += f'using T = utils::Typelist<{types}>;\n'
+    for index in range(lists):
+        text += (f'static_assert(utils::contains_v<T, std::integral_constant<unsigned, '
+                 f'{elements - 1 - index % elements}>>);\n')
+    return text
+
+
+# name: (generator, whether workload is repeated for each number of lists)
+WORKLOADS = {
+    'lists_termwise_or_t': (lambda elements, lists: termwise('or', elements, lists), True),
+    'lists_termwise_and_t': (lambda elements, lists: termwise('and', elements, lists), True),
+    'lists_termwise_xor_t': (lambda elements, lists: termwise('xor', elements, lists), True),
+    'push_back_value_t': (lambda elements, lists: push_back(elements), False),
+    'pop_front_t': (lambda elements, lists: pop_front(elements), False),
+    'contains_v': (contains, True),
+}
+
+
+def compile_unit(arguments, source, repeat, memory_limit):
+    """Compiles source 'repeat' times, returns the smallest time, s, and the largest peak memory, KiB.
+       Time is None, if compilation fails"""
+    def limit():
+        resource.setrlimit(resource.RLIMIT_AS, (memory_limit, memory_limit))
+
+    best, memory = None, 0
+    for _ in range(repeat):
+        start = time.perf_counter()
+        process = subprocess.Popen(arguments + [source], stderr=subprocess.PIPE, preexec_fn=limit)
+        _, status, usage = os.wait4(process.pid, 0)
+        elapsed = time.perf_counter() - start
+        errors = process.stderr.read().decode()
+        process.stderr.close()
+        if os.waitstatus_to_exitcode(status) != 0:
+            print(f'{os.path.basename(source)}: compilation failed\n{errors}', file=sys.stderr)
+            return None, max(memory, usage.ru_maxrss)
+        best = elapsed if best is None else min(best, elapsed)
+        memory = max(memory, usage.ru_maxrss)
+    return best, memory
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--cxx', default=os.environ.get('CXX', 'g++'), help='compiler, $CXX or g++ by default')
+    parser.add_argument('--include', default=os.path.join(os.path.dirname(__file__), '..', 'src'),
+                        help='directory of type_traits_custom.hpp')
+    parser.add_argument('--repeat', type=int, default=3, help='compilations per workload, the fastest is taken')
+    parser.add_argument('--elements', type=int, nargs='+', default=ELEMENTS, help='elements per list')
+    parser.add_argument('--lists', type=int, nargs='+', default=LISTS, help='number of lists')
+    parser.add_argument('--workloads', nargs='+', default=list(WORKLOADS), choices=list(WORKLOADS))
+    parser.add_argument('--memory-limit', type=int, default=4096, help='compiler memory limit, MiB')
+    options = parser.parse_args()
+
+    arguments = [options.cxx, '-std=c++17', '-fsyntax-only', '-I', os.path.abspath(options.include)]
+
+    with tempfile.TemporaryDirectory() as directory:
+        def run(name, text):
+            source = os.path.join(directory, name + '.cpp')
+            with open(source, 'w') as file:
+                file.write(HEADER + text)
+            return compile_unit(arguments, source, options.repeat, options.memory_limit << 20)
+
+        baseline, memory = run('baseline', '')
+        if baseline is None:
+            sys.exit(1)
+        print('workload,elements,lists,seconds,workload_seconds,peak_kib')
+        print(f'baseline,0,0,{baseline:.3f},0.000,{memory}')
+        sys.stdout.flush()
+        failed = False
+        for workload in options.workloads:
+            generate, per_list = WORKLOADS[workload]
+            for elements in options.elements:
+                for lists in options.lists if per_list else (1,):
+                    seconds, memory = run(f'{workload}_{elements}_{lists}', generate(elements, lists))
+                    if seconds is None:
+                        failed = True
+                        print(f'{workload},{elements},{lists},,,{memory}')
+                    else:
+                        print(f'{workload},{elements},{lists},{seconds:.3f},{max(seconds - baseline, 0):.3f},{memory}')
+                    sys.stdout.flush()
+        if failed:
+            sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
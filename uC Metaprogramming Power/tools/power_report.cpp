@@ -0,0 +1,20 @@
+/*
+  Power budget report: estimated supply current of each state of 'PowerModes' from PowerModes.hpp,
+  which is used by main.cpp too. Computed from 'current' traits of peripherals and their dependencies.
+  Run by 'make report'
+*/
+
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
+#include "PowerModes.hpp"
+
+int main(){
+  static_assert(std::size(powerModesNames) == PowerModes::currents.size(), "Name of each state is required");
+
+  std::printf("%-16s %10s\n", "state", "current,uA");
+  for(std::size_t i = 0; i < PowerModes::currents.size(); ++i)
+    std::printf("%-16s %10u\n", powerModesNames[i], static_cast<unsigned>(PowerModes::currents[i]));
+  std::printf("Peripherals without 'current' trait are not counted\n");
+  return 0;
+}